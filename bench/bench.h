@@ -0,0 +1,36 @@
+/*
+ * Helpers shared by the benchmark programs. Each benchmark times its
+ * operations one at a time into a benchTimer and then prints one line per
+ * operation in this format, so the results can be collected with grep:
+ *
+ * BENCH bench=<program> op=<operation> n=<count> ops_per_sec=<rate> p50_ns=<..> p90_ns=<..> p99_ns=<..> max_ns=<..>
+ *
+ * ops_per_sec is n over the currentTime() between benchStart() and
+ * benchReport(), so it includes whatever else the loop does. Per-operation latencies use the
+ * host's cycle counter when it has one, scaled to nanoseconds against
+ * currentTime(); otherwise they have the clock's microsecond resolution.
+ *
+ * Benchmarks that count something instead of timing it, such as kernel
+ * counters from getKernelStats(), print the count per operation:
+ *
+ * BENCH bench=<program> op=<operation> n=<count> per_op=<..>
+ */
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+struct benchTimer {
+    unsigned long long *samples; // latency of each operation, in cycles
+    int count;
+    int maxSamples;
+    int startTime; // currentTime() when the timer was started
+    unsigned long long startCycles;
+};
+
+extern unsigned long long benchCycles(void);
+extern void benchStart (struct benchTimer *timer, int maxSamples);
+extern void benchRecord(struct benchTimer *timer, unsigned long long startCycles);
+extern void benchReport(struct benchTimer *timer, char *bench, char *op);
+extern void benchReportCount(char *bench, char *op, int n, long count);
+
+#endif /* _BENCH_H */
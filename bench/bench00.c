@@ -0,0 +1,90 @@
+/*
+ * Benchmark: fill the process table completely, then drain it with join(),
+ * thousands of times.  Reports the latency of every spork(), and separately
+ * of the sporks done while the table was nearly full (the case that used to
+ * degrade into a full scan).
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <stackpool.h>
+#include "bench.h"
+
+#define ROUNDS 2000
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, j, kidpid, status;
+    int perRound = 0;
+    unsigned long long start;
+    struct benchTimer all, nearFull, drain;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: fill and drain the process table %d times; spork() costs the same when the table is nearly full.\n", ROUNDS);
+
+    benchStart(&all, ROUNDS * MAXPROC);
+    benchStart(&nearFull, ROUNDS * 8);
+    benchStart(&drain, ROUNDS * MAXPROC);
+
+    for (j = 0; j < ROUNDS; j++) {
+        for (i = 0; ; i++) {
+            start = benchCycles();
+            kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+
+            if (kidpid == -1)
+                break;
+            if (kidpid < 0) {
+                USLOSS_Console("ERROR: testcase_main(): spork() failed!!!  rc=%d\n", kidpid);
+                USLOSS_Halt(1);
+            }
+
+            benchRecord(&all, start);
+            if (i >= MAXPROC - 8)
+                benchRecord(&nearFull, start);
+
+            TEMP_switchTo(kidpid);
+        }
+
+        if (j == 0)
+            perRound = i;
+        else if (i != perRound) {
+            USLOSS_Console("ERROR: round %d created %d processes, round 0 created %d\n", j, i, perRound);
+            USLOSS_Halt(1);
+        }
+
+        for (i = 0; i < perRound; i++) {
+            start = benchCycles();
+            kidpid = join(&status);
+            benchRecord(&drain, start);
+            if (kidpid < 0) {
+                USLOSS_Console("ERROR: testcase_main(): join() failed!!!  rc=%d\n", kidpid);
+                USLOSS_Halt(1);
+            }
+        }
+    }
+
+    benchReport(&all, "fill_drain", "spork");
+    benchReport(&nearFull, "fill_drain", "spork_nearly_full");
+    benchReport(&drain, "fill_drain", "join");
+
+    struct stackPoolStats stats;
+    stackPoolGetStats(&stats);
+    USLOSS_Console("BENCH bench=fill_drain stack_mallocs=%d stack_reuses=%d peak_stacks=%d\n",
+                   stats.mallocs, stats.reuses, stats.peakInUse);
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(0, tm_pid);
+}
@@ -0,0 +1,85 @@
+/*
+ * Benchmark: cost of the dispatcher's decision when many processes are
+ * runnable.
+ *
+ * testcase_main sporks children at priority 1, above its own, which in
+ * phase 1a stay on the run queue instead of running.  It then calls the
+ * kernel's chooseNext(), the part of the dispatcher that picks the next
+ * process, over and over with interrupts disabled, first with one runnable
+ * child and then with every slot of the table in use; the two should cost
+ * about the same.  Nothing is switched to, so context switches and the
+ * stack pool are not part of the numbers.  Like bench02, the loop is timed
+ * as a whole, since one decision takes less time than reading the cycle
+ * counter.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <pcb.h>
+#include "bench.h"
+
+#define ITERATIONS 10000000
+
+/* the dispatcher's decision, from phase1.c */
+extern struct pcb *chooseNext(void);
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+/* queue 'runnable' children and time ITERATIONS decisions */
+static void decisions(int runnable, char *op)
+{
+    int i, firstPid = -1, status;
+    unsigned int prevPsr;
+    unsigned long long start, cycles;
+    struct pcb * volatile next = NULL;
+
+    for (i = 0; i < runnable; i++) {
+        int pid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 1);
+        if (pid < 0) {
+            USLOSS_Console("ERROR: could not create %d children\n", runnable);
+            USLOSS_Halt(1);
+        }
+        if (firstPid == -1)
+            firstPid = pid;
+    }
+
+    prevPsr = enterKernel("decisions");
+    start = benchCycles();
+    for (i = 0; i < ITERATIONS; i++)
+        next = chooseNext();
+    cycles = benchCycles() - start;
+    leaveKernel(prevPsr);
+
+    if (next == NULL || next->pid != firstPid) {
+        USLOSS_Console("ERROR: chooseNext() did not pick the oldest runnable child, pid %d\n", firstPid);
+        USLOSS_Halt(1);
+    }
+    USLOSS_Console("BENCH bench=dispatch op=%s n=%d cycles_per_decision=%.2f\n",
+                   op, ITERATIONS, (double)cycles / ITERATIONS);
+
+    for (i = 0; i < runnable; i++)
+        join(&status);
+}
+
+int testcase_main()
+{
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: a dispatch decision costs the same with 1 or %d runnable processes.\n", MAXPROC - 2);
+
+    decisions(1, "choose_next_1_runnable");
+    decisions(MAXPROC - 2, "choose_next_table_full");
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(0, tm_pid);
+}
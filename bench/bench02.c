@@ -0,0 +1,80 @@
+/*
+ * Micro-benchmark: cost of scanning the scheduling fields of every PCB,
+ * with the old interleaved PCB layout (name and context pointers mixed in
+ * with pid/state/priority) versus the split layout phase1.c uses now (a
+ * 64-byte, cache-line aligned struct of hot fields, with the name and the
+ * rest in a separate array).
+ *
+ * The old layout is copied here; the split layout is struct pcb from pcb.h,
+ * the same struct phase1.c schedules with, so the numbers follow it if it
+ * changes.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <pcb.h>
+#include "bench.h"
+
+#define ENTRIES 8192
+#define SCANS   200
+
+/* the PCB before it was split */
+struct oldPcb {
+    char name[MAXNAME];
+    int pid;
+    int priority;
+    int state;
+    int status;
+    int (*startFunc)(void *);
+    void *arg;
+    struct oldPcb *parent;
+    struct oldPcb *youngestChild;
+    struct oldPcb *nextOlderSibling;
+    USLOSS_Context *context;
+};
+
+int testcase_main()
+{
+    int i, j;
+    volatile int found = 0;
+    unsigned long long start, oldCycles, newCycles;
+
+    struct oldPcb *oldTable = calloc(ENTRIES, sizeof(struct oldPcb));
+    struct pcb *newTable = aligned_alloc(64, ENTRIES * sizeof(struct pcb));
+    for (i = 0; i < ENTRIES; i++) {
+        oldTable[i].pid = newTable[i].pid = (i % 3 == 0) ? -1 : i;
+        oldTable[i].priority = newTable[i].priority = i % 5 + 1;
+        oldTable[i].state = newTable[i].state = i % 3;
+    }
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: scanning pid/state/priority is cheaper with the split PCB layout.\n");
+
+    /* count runnable, high priority processes, as a scheduler scan would */
+    start = benchCycles();
+    for (j = 0; j < SCANS; j++)
+        for (i = 0; i < ENTRIES; i++)
+            if (oldTable[i].pid != -1 && oldTable[i].state == 0 && oldTable[i].priority < 3)
+                found++;
+    oldCycles = benchCycles() - start;
+
+    start = benchCycles();
+    for (j = 0; j < SCANS; j++)
+        for (i = 0; i < ENTRIES; i++)
+            if (newTable[i].pid != -1 && newTable[i].state == 0 && newTable[i].priority < 3)
+                found++;
+    newCycles = benchCycles() - start;
+
+    USLOSS_Console("BENCH bench=pcb_layout op=scan_old_layout entries=%d bytes_per_entry=%d cycles_per_entry=%.2f\n",
+                   ENTRIES, (int)sizeof(struct oldPcb), (double)oldCycles / (SCANS * ENTRIES));
+    USLOSS_Console("BENCH bench=pcb_layout op=scan_split_layout entries=%d bytes_per_entry=%d cycles_per_entry=%.2f\n",
+                   ENTRIES, (int)sizeof(struct pcb), (double)newCycles / (SCANS * ENTRIES));
+
+    free(oldTable);
+    free(newTable);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Benchmark: context switch ping-pong.  Two processes switch back and
+ * forth with TEMP_switchTo(); each sample is one round trip (two context
+ * switches).
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define ROUND_TRIPS 200000
+
+int Ping(void *), Pong(void *);
+
+int tm_pid = -1;
+int ping_pid, pong_pid;
+int done = 0;
+
+int testcase_main()
+{
+    int status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: two processes switch back and forth %d times.\n", ROUND_TRIPS);
+
+    ping_pid = spork("Ping", Ping, NULL, USLOSS_MIN_STACK, 2);
+    pong_pid = spork("Pong", Pong, NULL, USLOSS_MIN_STACK, 2);
+
+    TEMP_switchTo(ping_pid);
+    join(&status);
+
+    /* Pong is still waiting for Ping to switch back; let it see that we're done */
+    TEMP_switchTo(pong_pid);
+    join(&status);
+
+    return 0;
+}
+
+int Ping(void *arg)
+{
+    int i;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    benchStart(&timer, ROUND_TRIPS);
+    for (i = 0; i < ROUND_TRIPS; i++) {
+        start = benchCycles();
+        TEMP_switchTo(pong_pid);
+        benchRecord(&timer, start);
+    }
+    benchReport(&timer, "pingpong", "switch_round_trip");
+
+    done = 1;
+    quit_phase_1a(0, tm_pid);
+}
+
+int Pong(void *arg)
+{
+    while (!done)
+        TEMP_switchTo(ping_pid);
+    quit_phase_1a(0, tm_pid);
+}
@@ -0,0 +1,45 @@
+/*
+ * Benchmark: spork()/quit()/join() loop.  testcase_main creates a child,
+ * blocks in join(), the dispatcher runs the child, which quits right away,
+ * and testcase_main reaps it.  Each sample is one whole process lifetime.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define ITERATIONS 200000
+
+int XXp1(void *);
+
+int testcase_main()
+{
+    int i, kidpid, status;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: create, run and reap a child %d times.\n", ITERATIONS);
+
+    benchStart(&timer, ITERATIONS);
+    for (i = 0; i < ITERATIONS; i++) {
+        start = benchCycles();
+        kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 4);
+        if (join(&status) != kidpid) {
+            USLOSS_Console("ERROR: join() did not return child %d\n", kidpid);
+            USLOSS_Halt(1);
+        }
+        benchRecord(&timer, start);
+    }
+    benchReport(&timer, "spork_quit_join", "lifetime");
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit(0);
+}
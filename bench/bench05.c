@@ -0,0 +1,57 @@
+/*
+ * Benchmark: deep process chains.  Each process in the chain sporks one
+ * child and joins it, down to CHAIN_DEPTH processes (as many as the table
+ * holds); then the chain unwinds as each process quits.  Each sample is
+ * one whole chain being built and torn down.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define CHAIN_DEPTH (MAXPROC - 2)
+#define CHAINS      2000
+
+int Link(void *);
+
+int testcase_main()
+{
+    int i, status;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: build and tear down a chain of %d processes %d times.\n", CHAIN_DEPTH, CHAINS);
+
+    benchStart(&timer, CHAINS);
+    for (i = 0; i < CHAINS; i++) {
+        start = benchCycles();
+        spork("Link", Link, (void *)1L, USLOSS_MIN_STACK, 4);
+        join(&status);
+        benchRecord(&timer, start);
+        if (status != CHAIN_DEPTH) {
+            USLOSS_Console("ERROR: chain %d was %d processes deep\n", i, status);
+            USLOSS_Halt(1);
+        }
+    }
+    benchReport(&timer, "chain", "build_and_unwind");
+
+    return 0;
+}
+
+/* arg is this process' depth in the chain; returns the depth of the whole chain */
+int Link(void *arg)
+{
+    long depth = (long)arg;
+    int status;
+
+    if (depth == CHAIN_DEPTH)
+        quit(depth);
+
+    spork("Link", Link, (void *)(depth + 1), USLOSS_MIN_STACK, 4);
+    join(&status);
+    quit(status);
+}
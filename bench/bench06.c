@@ -0,0 +1,55 @@
+/*
+ * Benchmark: PSR accesses per spork()/join() pair.  Same loop as bench04,
+ * but instead of timing it, counts the USLOSS_PsrGet()/USLOSS_PsrSet()
+ * calls the kernel makes for each child, from getKernelStats(), and times
+ * a getpid() loop, which is nothing but kernel entry and exit.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define ITERATIONS 100000
+
+int XXp1(void *);
+
+int testcase_main()
+{
+    int i, kidpid, status;
+    long before;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: create, run and reap a child %d times, then call getpid() %d times.\n", ITERATIONS, ITERATIONS);
+
+    before = getKernelStats().psrCalls;
+    for (i = 0; i < ITERATIONS; i++) {
+        kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 4);
+        if (join(&status) != kidpid) {
+            USLOSS_Console("ERROR: join() did not return child %d\n", kidpid);
+            USLOSS_Halt(1);
+        }
+    }
+    benchReportCount("psr_calls", "spork_join", ITERATIONS, getKernelStats().psrCalls - before);
+
+    before = getKernelStats().psrCalls;
+    benchStart(&timer, ITERATIONS);
+    for (i = 0; i < ITERATIONS; i++) {
+        start = benchCycles();
+        getpid();
+        benchRecord(&timer, start);
+    }
+    benchReport(&timer, "psr_calls", "getpid");
+    benchReportCount("psr_calls", "getpid", ITERATIONS, getKernelStats().psrCalls - before);
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit(0);
+}
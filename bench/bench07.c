@@ -0,0 +1,100 @@
+/*
+ * Benchmark: mailbox throughput.  Moves MESSAGES small messages through one
+ * mailbox with one sender and one receiver, four senders and one receiver,
+ * and one sender and four receivers.  The 1:1 case is run twice: with the
+ * receiver at a higher priority, so every message is handed straight to a
+ * waiting receiver, and at the same priority, so messages pile up in slots
+ * until the sender fills the mailbox and waits.  Each receive is timed,
+ * including any wait, and the share of messages that were handed off
+ * without a slot is printed for each case.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <phase2.h>
+#include "bench.h"
+
+#define MESSAGES 100000
+#define NUM_SLOTS 10
+
+int Sender(void *);
+int Receiver(void *);
+
+int benchMbox;
+int perSender;
+int perReceiver;
+struct benchTimer timer;
+
+void run(char *op, int senders, int receivers, int senderPriority, int receiverPriority)
+{
+    int i, status;
+    long handoffs;
+    struct mboxStats stats;
+
+    benchMbox = MboxCreate(NUM_SLOTS, sizeof(int));
+    perSender = MESSAGES / senders;
+    perReceiver = MESSAGES / receivers;
+    getMboxStats(&stats);
+    handoffs = stats.handoffs;
+
+    benchStart(&timer, MESSAGES);
+    for (i = 0; i < receivers; i++) {
+        spork("Receiver", Receiver, NULL, USLOSS_MIN_STACK, receiverPriority);
+    }
+    for (i = 0; i < senders; i++) {
+        spork("Sender", Sender, NULL, USLOSS_MIN_STACK, senderPriority);
+    }
+    for (i = 0; i < senders + receivers; i++) {
+        join(&status);
+    }
+    benchReport(&timer, "mbox", op);
+
+    getMboxStats(&stats);
+    benchReportCount("mbox_handoffs", op, MESSAGES, stats.handoffs - handoffs);
+    MboxRelease(benchMbox);
+}
+
+int testcase_main()
+{
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: send %d messages through a %d slot mailbox for each pattern.\n", MESSAGES, NUM_SLOTS);
+
+    run("1to1_handoff", 1, 1, 4, 2);
+    run("1to1_slots", 1, 1, 4, 4);
+    run("4to1", 4, 1, 4, 4);
+    run("1to4", 1, 4, 4, 4);
+
+    return 0;
+}
+
+int Sender(void *arg)
+{
+    int i;
+
+    for (i = 0; i < perSender; i++) {
+        if (MboxSend(benchMbox, &i, sizeof(i)) != 0) {
+            USLOSS_Console("ERROR: MboxSend() failed\n");
+            USLOSS_Halt(1);
+        }
+    }
+    return 0;
+}
+
+int Receiver(void *arg)
+{
+    int i, msg;
+    unsigned long long start;
+
+    for (i = 0; i < perReceiver; i++) {
+        start = benchCycles();
+        if (MboxRecv(benchMbox, &msg, sizeof(msg)) != sizeof(msg)) {
+            USLOSS_Console("ERROR: MboxRecv() failed\n");
+            USLOSS_Halt(1);
+        }
+        benchRecord(&timer, start);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+/*
+ * Benchmark: read-only kernel queries.  Calls getpid(), getpriority(),
+ * getstate() and getparent() in a loop, timing each call, and prints the
+ * USLOSS_PsrGet()/USLOSS_PsrSet() calls each one makes, from
+ * getKernelStats().  None of them disables interrupts, so each should make
+ * only the one PSR read that checks for kernel mode.  For comparison it
+ * also times getChildCount(), which looks up a pid the same way as
+ * getstate() but with interrupts disabled by enterKernel()/leaveKernel(),
+ * as every query did before.
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define ITERATIONS 1000000
+
+int tm_pid;
+
+int queryGetpid(void)        { return getpid(); }
+int queryGetpriority(void)   { return getpriority(); }
+int queryGetstate(void)      { return getstate(tm_pid); }
+int queryGetparent(void)     { return getparent(tm_pid); }
+int queryGetChildCount(void) { return getChildCount(tm_pid); }
+
+void run(char *op, int (*query)(void))
+{
+    int i;
+    long before;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    before = getKernelStats().psrCalls;
+    benchStart(&timer, ITERATIONS);
+    for (i = 0; i < ITERATIONS; i++) {
+        start = benchCycles();
+        query();
+        benchRecord(&timer, start);
+    }
+    benchReport(&timer, "query", op);
+    benchReportCount("psr_calls", op, ITERATIONS, getKernelStats().psrCalls - before);
+}
+
+int testcase_main()
+{
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: call each query %d times.\n", ITERATIONS);
+
+    run("getpid", queryGetpid);
+    run("getpriority", queryGetpriority);
+    run("getstate", queryGetstate);
+    run("getparent", queryGetparent);
+    run("getChildCount", queryGetChildCount);
+
+    return 0;
+}
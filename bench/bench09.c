@@ -0,0 +1,82 @@
+/*
+ * Benchmark: creating a batch of BATCH identical children with a loop of
+ * spork() calls, and with one sporkMany() call.  Each batch is timed up to
+ * the point where every child exists; then the children are run and
+ * joined, outside the timing.  Also prints the USLOSS_PsrGet()/
+ * USLOSS_PsrSet() calls made per child created, from getKernelStats().
+ *
+ * This is not part of run_testcases.student; the numbers it prints change from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include "bench.h"
+
+#define ROUNDS 2000
+#define BATCH 32
+
+int Worker(void *);
+
+void joinBatch(void)
+{
+    int i, status;
+
+    for (i = 0; i < BATCH; i++) {
+        join(&status);
+    }
+}
+
+int testcase_main()
+{
+    int i, j;
+    int pids[BATCH];
+    long psrCalls;
+    long before;
+    unsigned long long start;
+    struct benchTimer timer;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: create and join %d batches of %d children each way.\n", ROUNDS, BATCH);
+
+    psrCalls = 0;
+    benchStart(&timer, ROUNDS);
+    for (i = 0; i < ROUNDS; i++) {
+        before = getKernelStats().psrCalls;
+        start = benchCycles();
+        for (j = 0; j < BATCH; j++) {
+            if (spork("Worker", Worker, NULL, USLOSS_MIN_STACK, 4) < 0) {
+                USLOSS_Console("ERROR: spork() failed\n");
+                USLOSS_Halt(1);
+            }
+        }
+        benchRecord(&timer, start);
+        psrCalls += getKernelStats().psrCalls - before;
+        joinBatch();
+    }
+    benchReport(&timer, "spork_batch", "spork_loop");
+    benchReportCount("psr_calls", "spork_loop", ROUNDS * BATCH, psrCalls);
+
+    psrCalls = 0;
+    benchStart(&timer, ROUNDS);
+    for (i = 0; i < ROUNDS; i++) {
+        before = getKernelStats().psrCalls;
+        start = benchCycles();
+        if (sporkMany("Worker", Worker, NULL, BATCH, USLOSS_MIN_STACK, 4, pids) != 0) {
+            USLOSS_Console("ERROR: sporkMany() failed\n");
+            USLOSS_Halt(1);
+        }
+        benchRecord(&timer, start);
+        psrCalls += getKernelStats().psrCalls - before;
+        joinBatch();
+    }
+    benchReport(&timer, "spork_batch", "sporkMany");
+    benchReportCount("psr_calls", "sporkMany", ROUNDS * BATCH, psrCalls);
+
+    return 0;
+}
+
+int Worker(void *arg)
+{
+    quit(0);
+}
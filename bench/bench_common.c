@@ -0,0 +1,85 @@
+/*
+ * Helpers shared by the benchmark programs; see bench.h.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <usloss.h>
+#include "bench.h"
+
+extern int currentTime(void);
+
+/* cycle counter if the host has one, otherwise the USLOSS clock (in microseconds) */
+unsigned long long benchCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return currentTime();
+#endif
+}
+
+void benchStart(struct benchTimer *timer, int maxSamples)
+{
+    timer->samples = malloc(maxSamples * sizeof(unsigned long long));
+    if (timer->samples == NULL) {
+        USLOSS_Console("ERROR: benchStart(): out of memory\n");
+        USLOSS_Halt(1);
+    }
+    timer->count = 0;
+    timer->maxSamples = maxSamples;
+    timer->startTime = currentTime();
+    timer->startCycles = benchCycles();
+}
+
+/* record one operation that started at startCycles and has just finished */
+void benchRecord(struct benchTimer *timer, unsigned long long startCycles)
+{
+    unsigned long long now = benchCycles();
+    if (timer->count < timer->maxSamples)
+        timer->samples[timer->count++] = now - startCycles;
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    unsigned long long x = *(const unsigned long long *)a;
+    unsigned long long y = *(const unsigned long long *)b;
+    return (x > y) - (x < y);
+}
+
+void benchReport(struct benchTimer *timer, char *bench, char *op)
+{
+    int elapsed = currentTime() - timer->startTime;
+    unsigned long long cycles = benchCycles() - timer->startCycles;
+    int n = timer->count;
+
+    if (elapsed <= 0)
+        elapsed = 1;
+    if (cycles == 0)
+        cycles = 1;
+
+    /* nanoseconds per cycle */
+    double scale = (elapsed * 1000.0) / cycles;
+
+    qsort(timer->samples, n, sizeof(unsigned long long), compareSamples);
+
+    double p50 = 0, p90 = 0, p99 = 0, max = 0;
+    if (n > 0) {
+        p50 = timer->samples[(int)(n * 0.50)] * scale;
+        p90 = timer->samples[(int)(n * 0.90)] * scale;
+        p99 = timer->samples[(int)(n * 0.99)] * scale;
+        max = timer->samples[n - 1] * scale;
+    }
+
+    USLOSS_Console("BENCH bench=%s op=%s n=%d ops_per_sec=%.0f p50_ns=%.0f p90_ns=%.0f p99_ns=%.0f max_ns=%.0f\n",
+                   bench, op, n, n * 1000000.0 / elapsed, p50, p90, p99, max);
+
+    free(timer->samples);
+    timer->samples = NULL;
+}
+
+void benchReportCount(char *bench, char *op, int n, long count)
+{
+    USLOSS_Console("BENCH bench=%s op=%s n=%d per_op=%.2f\n",
+                   bench, op, n, (n > 0) ? (double)count / n : 0.0);
+}
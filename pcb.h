@@ -0,0 +1,39 @@
+/*
+ * The hot half of the kernel's process control block: the fields that are
+ * used when scheduling and walking the process tree. The rest of a PCB is in
+ * struct pcbCold, which is private to phase1.c.
+ *
+ * This is kept in its own header so that bench/bench02.c measures scans of
+ * the same struct the kernel uses.
+ */
+
+#ifndef _PCB_H
+#define _PCB_H
+
+/*
+ * PID, priorities, state, and pointers to the process' parent, youngest
+ * child, siblings on either side and neighbours in its run queue. It is
+ * exactly one cache line, so scans of the table don't drag in names and
+ * contexts.
+ */
+
+struct pcb {
+	int pid; // -1 if no process
+	short priority; // priority the process was created with
+	short effectivePriority; // priority it is scheduled at, raised by priority inheritance
+	int state; // 0 = Runnable, 1 = Running, 2 = Terminated, 3 = Blocked
+	int blockReason; // why the process is blocked, 0 if it isn't
+	struct pcb *parent;
+	// each process points to its youngest live child; the live children are a doubly linked list
+	// from youngest to oldest, so any of them can be unlinked without a walk
+	struct pcb *youngestChild;
+	struct pcb *nextOlderSibling;
+	struct pcb *prevYoungerSibling;
+	// links in the run queue for the process' priority, while it is Runnable
+	struct pcb *nextInQueue;
+	struct pcb *prevInQueue;
+} __attribute__((aligned(64)));
+
+_Static_assert(sizeof(struct pcb) == 64, "struct pcb should fill exactly one cache line");
+
+#endif /* _PCB_H */
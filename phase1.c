@@ -2,13 +2,19 @@
  * Authors: Colton Patch, Ping Tontrasathien
  * phase1.c - Implements phase1a; defines functions for initializing the PCB table, creating
  * 	a new child process, joining dead processes with their parents, and quitting the current process.
- * 	Processes are switched to manually as there is no dispatcher.
+ * 	Processes are mostly switched to manually in phase1a, but a process that has to wait in join() 
+ * 	gives the CPU to the dispatcher, which runs the highest priority runnable process.
  */
 
 #include <phase1.h>
+#include <pcb.h>
+#include <stackpool.h>
+#include <trace.h>
+#include <schedlog.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 //
 // prototypes
@@ -16,28 +22,127 @@
 void startFuncWrapper(void);
 int startFuncInit(void *);
 int testcase_mainWrapper(void *);
-int checkForKernelMode(void);
-unsigned int disableInterrupts(void);
-void restoreInterrupts(unsigned int prevPsr);
-//void dispatcher(void);
+void requireKernelMode(char *func);
+int findFreeSlot(int start);
+int initTable(int size);
+int growTable(void);
+struct pcb *allocPcb(void);
+void initProc(struct pcb *newProc, struct stackBlock *block, char *name, int(*func)(void *), void *arg, int priority);
+struct pcbCold *coldOf(struct pcb *proc);
+struct pcb *lookupPid(int pid);
+struct pcb *peekPid(int pid, unsigned int seq);
+void dispatcher(void);
+void dispatchFor(int reason);
+struct pcb *chooseNext(void);
+int replayDecision(int reason);
+void enqueue(struct pcb *proc);
+void dequeue(struct pcb *proc);
+void switchTo(struct pcb *newProc);
+void terminate(int status);
+void adoptOrphans(struct pcb *proc);
+void donatePriority(struct pcb *proc, int priority);
+void releaseDeadStack(void);
+int readClock(void);
+void clockHandler(int dev, void *arg);
+void preemptionPoint(void);
+int timeSliceOver(void);
 
 //
-// structure for a process control block. Contains PID, name, priority, current context, the process' 
-// start function and argument, and pointers to its parent, youngest child, and next older sibling
+// number of PCBs allocated at a time when there are no unused ones left. Their hot halves fill
+// PCB_PAGE_BYTES, a power of two, and the page is aligned to that so coldOf() can find its start
 //
-struct pcb {
+#define PCB_PAGE_SIZE 64
+#define PCB_PAGE_BYTES (PCB_PAGE_SIZE * 64)
+
+//
+// lowest priority (highest number) a process can have; only init runs at this priority
+//
+#define LOWEST_PRIORITY 6
+
+//
+// default length of a time slice in milliseconds. Phase 1a testcases switch processes by hand,
+// so there is no time slicing unless they ask for it with setTimeSlice(), or are built with
+// -DDEFAULT_TIME_SLICE=n as the Makefile's SLICED_TESTS are
+//
+#ifndef DEFAULT_TIME_SLICE
+#ifdef PHASE_1A
+#define DEFAULT_TIME_SLICE 0
+#else
+#define DEFAULT_TIME_SLICE 80
+#endif
+#endif
+
+//
+// kernel statistics are kept unless compiled with -DNO_KERNEL_STATS. STAT(x) runs x only when
+// they are kept; every use is on a path that already has interrupts disabled
+//
+#ifndef NO_KERNEL_STATS
+#define STAT(statement) statement
+#else
+#define STAT(statement)
+#endif
+
+//
+// scheduler events are recorded in the trace ring unless compiled with -DNO_KERNEL_TRACE. Like
+// STAT(), every use is on a path that already has interrupts disabled
+//
+#ifndef NO_KERNEL_TRACE
+#define TRACE(type, pid, otherPid, status) traceRecord(type, pid, otherPid, status)
+#else
+#define TRACE(type, pid, otherPid, status)
+#endif
+
+//
+// keeps the compiler from moving memory reads and writes across it, or reusing values read before
+// it. The read-only queries read the table with interrupts enabled, so a clock interrupt can switch
+// processes between any two reads; they need each read done where it is written
+//
+#define KERNEL_BARRIER() __asm__ volatile("" ::: "memory")
+
+//
+// most tables growTable() can replace. Each one is twice the size of the last, so the table size
+// would overflow an int before there are this many
+//
+#define MAX_RETIRED_TABLES 32
+
+//
+// longest line printed by dumpProcesses(): a name of MAXNAME characters, and numbers of at most 11
+//
+#define DUMP_LINE_SIZE (MAXNAME + 80)
+
+//
+// reasons a process can be blocked
+//
+#define JOIN_BLOCK 1 // waiting in join() for a child to die
+#define ZAP_BLOCK 2 // waiting in zap() for a process to quit
+#define MAX_KERNEL_BLOCK 10 // reasons up to this are used by phase 1; blockMe() callers use higher ones
+
+_Static_assert(PCB_PAGE_SIZE * sizeof(struct pcb) == PCB_PAGE_BYTES, "the hot halves should fill PCB_PAGE_BYTES");
+
+//
+// the rest of a process control block: name, return status, the process' start function and 
+// argument, current context and stack. Children are moved to the parent's deadChildren list 
+// when they quit, so join() never has to search for a dead child.
+//
+struct pcbCold {
 	char name[MAXNAME];
-	int pid; // -1 if no process
-	int priority;
-	int state; // 0 = Runnable, 1 = Running, 2 = Terminated
 	int status; // return status, NULL if still alive
+	int slot; // index in pcbTable
+	int numChildren; // number of live children
 	int (*startFunc)(void *);
 	void *arg;
-	struct pcb *parent;
-	// each process points to its youngest child, which points to its next older sibling and so on
-	struct pcb *youngestChild;
-	struct pcb *nextOlderSibling;
+	// terminated children that haven't been joined, most recently terminated first
+	struct pcb *deadChildren;
+	struct pcb *nextDeadSibling;
+	// processes waiting in zap() for this one to quit, linked by nextZapper
+	struct pcb *zappers;
+	struct pcb *nextZapper;
+	struct pcb *zapTarget; // process this one is waiting for in zap(), NULL if none
 	USLOSS_Context *context;
+	struct stackBlock *stackBlock; // stack and context from the stack pool, NULL for init
+	int switches; // number of times the process has been switched to
+	int cpuTime; // microseconds spent running, not counting the current time slice
+	int lastDispatch; // clock time when the process was last switched to
 };
 
 //
@@ -45,54 +150,135 @@ struct pcb {
 //
 int nextId = 1; // The ID of the next process
 int numProcs = 0; // number of processes
-struct pcb pcbTable[MAXPROC]; // table of PCBs
+int maxProcs = MAXPROC; // maximum number of processes that can exist at once
+int tableSize = 0; // number of slots in pcbTable; the process with pid p is in slot p % tableSize
+struct pcb **pcbTable; // table of PCBs indexed by slot, NULL if the slot is unused
+// tables replaced by growTable(). They are never freed, like PCB pages, because getstate() and
+// getparent() may still be reading one after a context switch. Each is half the size of the next,
+// so together they take less memory than pcbTable
+struct pcb **retiredTables[MAX_RETIRED_TABLES];
+int numRetiredTables = 0;
+unsigned long long *freeSlots; // bitmap where bit i is set when slot i is unused
+struct pcb *freePcbs; // unused PCBs, linked by nextOlderSibling. PCBs are allocated in pages and never move
 struct pcb *curProc; // currently running process
+volatile unsigned int switchCount = 0; // context switches so far; the read-only queries retry if it changes under them
+int preemptionPoints = 0; // kernel entries made with interrupts enabled by the current process since it was switched to
 char initStack[USLOSS_MIN_STACK]; // stack for init
-char *stateArr[3] = {"Runnable", "Running", "Terminated"};
+char *stateArr[4] = {"Runnable", "Running", "Terminated", "Blocked"};
 USLOSS_Context initContext; // context for init
-// struct pcb *queue1, *queue2, *queue3, *queue4, *queue5, *queue6; // queues for each priority
+// run queue for each priority, indexed by priority (0 is unused). Runnable processes are
+// added at the tail and taken from the head
+struct pcb *queueHead[LOWEST_PRIORITY + 1];
+struct pcb *queueTail[LOWEST_PRIORITY + 1];
+unsigned int readyLevels = 0; // bit p is set when the queue for priority p is not empty
+struct stackBlock *deadStack = NULL; // stack of a process that just quit, released by the next process to run
+struct kernelStats kernelStats; // counters kept on the kernel's hot paths
+int curStartTime = 0; // clock time when the current process was switched to
+int timeSlice = DEFAULT_TIME_SLICE; // milliseconds a process runs before others of its priority get a turn, 0 for no limit
+int priorityInheritance = 0; // 1 if processes waiting in join() or zap() lend their priority to the processes they wait for
+int reparentOrphans = 0; // 1 if the children of a process that quits go to init, 0 if quitting with children halts
 
 //
 // functions
 //
 
 /*
-* void phase1_init(void) - creates the PCB table and the PCB structure for the 
-*	init process.
+* void phase1_init(void) - creates the PCB table, with room for MAXPROC processes, and the PCB 
+*	structure for the init process.
 */
 void phase1_init(void) {
+	phase1_init_ex(MAXPROC);
+}
+
+/*
+* void phase1_init_ex(int maxProcesses) - creates the PCB table and the PCB structure for the 
+*	init process.
+*	maxProcesses - the maximum number of processes that can exist at once, including init
+*/
+void phase1_init_ex(int maxProcesses) {
 	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call phase1_init while in user mode!\n");
+	unsigned int prevPsr = enterKernel("phase1_init");
+
+	// create the table with every slot free
+	if (maxProcesses < 2 || initTable(maxProcesses) == -1) {
+		USLOSS_Trace("ERROR: Could not create a process table for %d processes\n", maxProcesses);
 		USLOSS_Halt(1);
 	}
-	unsigned int prevPsr = disableInterrupts();
+	maxProcs = maxProcesses;
 
 	// make pcb entry for init
-	strcpy(pcbTable[1].name, "init");
-	pcbTable[1].pid	=  nextId;
-	pcbTable[1].priority = 6;
-	pcbTable[1].state = 0;
-	pcbTable[1].startFunc = &startFuncInit; // init's start function
-	pcbTable[1].arg = NULL;
-	pcbTable[1].parent = &pcbTable[0];	
-	pcbTable[1].context = &initContext;
+	struct pcb *init = allocPcb();
+	struct pcbCold *initCold = coldOf(init);
+	strcpy(initCold->name, "init");
+	init->pid = nextId;
+	init->priority = 6;
+	init->effectivePriority = 6;
+	init->state = 0;
+	initCold->startFunc = &startFuncInit; // init's start function
+	initCold->arg = NULL;
+	init->parent = NULL;
+	init->youngestChild = NULL;
+	init->nextOlderSibling = NULL;
+	init->prevYoungerSibling = NULL;
+	initCold->numChildren = 0;
+	initCold->deadChildren = NULL;
+	initCold->nextDeadSibling = NULL;
+	initCold->zappers = NULL;
+	initCold->nextZapper = NULL;
+	initCold->zapTarget = NULL;
+	initCold->slot = nextId % tableSize;
+	initCold->context = &initContext;
+	initCold->stackBlock = NULL;
+	initCold->switches = 0;
+	initCold->cpuTime = 0;
+	initCold->lastDispatch = 0;
+	init->blockReason = 0;
+	pcbTable[initCold->slot] = init;
+	enqueue(init);
+	freeSlots[initCold->slot / 64] &= ~(1ULL << (initCold->slot % 64));
 	nextId++;
 
-	// set all other entries' pid to -1
-	pcbTable[0].pid = -1;
-	for (int i = 2; i < MAXPROC; i++) {
-		pcbTable[i].pid = -1;
-	}
-
 	// initialize context for init
-	USLOSS_ContextInit(pcbTable[1].context, initStack, USLOSS_MIN_STACK, NULL, &startFuncWrapper);
+	USLOSS_ContextInit(initCold->context, initStack, USLOSS_MIN_STACK, NULL, &startFuncWrapper);
+
+	// take over clock interrupts for time slicing
+	USLOSS_IntVec[USLOSS_CLOCK_INT] = &clockHandler;
+
+	// write out the trace when the simulation exits, if asked to
+#ifndef NO_KERNEL_TRACE
+	atexit(&traceDumpAtExit);
+#endif
+
+	// start recording or replaying the schedule, if asked to
+	schedLogInit();
 
 	// increment number of processes
 	numProcs++;
+	STAT(kernelStats.peakProcs = numProcs);
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+}
+
+/*
+* int setMaxProcs(int maxProcesses) - changes the maximum number of processes that can exist at once.
+*	The table grows as needed when processes are created. Returns -1 if more processes than that
+*	already exist, 0 otherwise.
+*	maxProcesses - the new maximum, including init
+*/
+int setMaxProcs(int maxProcesses) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("setMaxProcs");
+
+	if (maxProcesses < numProcs) {
+		leaveKernel(prevPsr);
+		return -1;
+	}
+	maxProcs = maxProcesses;
 
 	// restore interrupts
-	restoreInterrupts(prevPsr);
+	leaveKernel(prevPsr);
+	return 0;
 }
 
 
@@ -107,62 +293,251 @@ void phase1_init(void) {
 */
 int spork(char *name, int(*func)(void *), void *arg, int stackSize, int priority) {
 	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call spork while in user mode!\n");
-		USLOSS_Halt(1);
-	}
-	unsigned int prevPsr = disableInterrupts();
+	unsigned int prevPsr = enterKernel("spork");
 
 	// check for reasonable stack size
 	if ( stackSize < USLOSS_MIN_STACK) {
+		STAT(kernelStats.sporkFailStack++);
+		leaveKernel(prevPsr);
 		return -2;
 	}
 
 	// check if pcbTable is not full, priority is in range, start function and name is not null, name is not too long
-	if ( numProcs == MAXPROC || (priority < 1 || priority > 5) || (func == NULL || name == NULL || strlen(name) > MAXNAME) ) {
+	if ( numProcs >= maxProcs || (priority < 1 || priority > 5) || (func == NULL || name == NULL || strlen(name) > MAXNAME) ) {
+#ifndef NO_KERNEL_STATS
+		if (numProcs >= maxProcs) {
+			kernelStats.sporkFailFull++;
+		}
+		else {
+			kernelStats.sporkFailInvalid++;
+		}
+#endif
+		leaveKernel(prevPsr);
 		return -1;
 	}
 
-	// get slot in table
-	int slot = nextId % MAXPROC;
-	while (pcbTable[slot].pid != -1) {
-		nextId++;
-		slot = nextId % MAXPROC;
+	// make room in the table if every slot is in use
+	if (numProcs == tableSize && growTable() == -1) {
+		STAT(kernelStats.sporkFailFull++);
+		leaveKernel(prevPsr);
+		return -1;
 	}
 
- 	// define fields
-	pcbTable[slot].pid = nextId;
-	strcpy(pcbTable[slot].name, name);
-	pcbTable[slot].priority = priority;
-	pcbTable[slot].startFunc = func;
-	pcbTable[slot].arg = arg;
-	pcbTable[slot].state = 0;
-	pcbTable[slot].parent = curProc; // set parent to current process
-	pcbTable[slot].youngestChild = NULL;
-	pcbTable[slot].nextOlderSibling = curProc->youngestChild; // set older sibling to the youngest child of parent;	
-	nextId++;
-
-	// initialize context
-	char *newStack = malloc(sizeof(char) * stackSize);
-	pcbTable[slot].context = malloc(sizeof(USLOSS_Context));
-	USLOSS_ContextInit(pcbTable[slot].context, newStack, stackSize, NULL, &startFuncWrapper);
+	// get a stack and context from the pool, then a PCB; if there is no PCB, the stack goes back
+	struct stackBlock *block = stackPoolGet(stackSize);
+	struct pcb *newProc = (block == NULL) ? NULL : allocPcb();
+	if (newProc == NULL) {
+		if (block != NULL) {
+			stackPoolRelease(block);
+		}
+		STAT(kernelStats.sporkFailFull++);
+		leaveKernel(prevPsr);
+		return -1;
+	}
 
-	// increment number of processes
-	numProcs++;
+	initProc(newProc, block, name, func, arg, priority);
+	newProc->nextOlderSibling = curProc->youngestChild; // set older sibling to the youngest child of parent
+	newProc->prevYoungerSibling = NULL;
 
 	// update the youngest child of parent
 	if (curProc->youngestChild != NULL) {
-		pcbTable[slot].nextOlderSibling = curProc->youngestChild;
+		curProc->youngestChild->prevYoungerSibling = newProc;
 	}
-	curProc->youngestChild = &pcbTable[slot];
+	curProc->youngestChild = newProc;
+	coldOf(curProc)->numChildren++;
 
-	// call dispatcher
-	// dispatcher(); nothing happens in phase1a
+	// make it runnable, and run it now if it has a higher priority than the current process
+	enqueue(newProc);
+#ifndef PHASE_1A
+	dispatcher();
+#endif
 
 	// restore interrupts
-	restoreInterrupts(prevPsr);
+	leaveKernel(prevPsr);
 
-	return pcbTable[slot].pid;
+	return newProc->pid;
+}
+
+/*
+* int sporkMany(char *name, int(*func)(void *), void **args, int n, int stackSize, int priority,
+*	int *pids) - creates n children of the current process, all running func, and stores their 
+*	pids in pids, oldest first. Either all of them are created or none are: every PCB and stack 
+*	is reserved before any child is set up. The children are linked into the parent's children 
+*	together and added to their run queue together, in the order they were created. Returns 0 
+*	on success, -2 if the stack size is too small, and -1 if an argument is invalid or there is 
+*	no room for n more processes.
+*	name - name of the new processes
+*	func - start function of the new processes
+*	args - argument for each new process' start function, or NULL to pass NULL to all of them
+*	n - number of processes to create
+*	stackSize - size of the stack to be allocated for each new process
+*	priority - priority of the new processes
+*	pids - array of n entries to store the pids in
+*/
+int sporkMany(char *name, int(*func)(void *), void **args, int n, int stackSize, int priority, int *pids) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("sporkMany");
+
+	// check for reasonable stack size
+	if ( stackSize < USLOSS_MIN_STACK) {
+		STAT(kernelStats.sporkFailStack++);
+		leaveKernel(prevPsr);
+		return -2;
+	}
+
+	// check there is room for all n, and the rest of the arguments are the same as for spork()
+	if ( n > maxProcs - numProcs || n < 1 || pids == NULL || (priority < 1 || priority > 5) || (func == NULL || name == NULL || strlen(name) > MAXNAME) ) {
+#ifndef NO_KERNEL_STATS
+		if (n > maxProcs - numProcs) {
+			kernelStats.sporkFailFull++;
+		}
+		else {
+			kernelStats.sporkFailInvalid++;
+		}
+#endif
+		leaveKernel(prevPsr);
+		return -1;
+	}
+
+	// make room in the table for all of them
+	while (numProcs + n > tableSize) {
+		if (growTable() == -1) {
+			STAT(kernelStats.sporkFailFull++);
+			leaveKernel(prevPsr);
+			return -1;
+		}
+	}
+
+	// reserve a PCB and a stack for each child. They are chained the way they will be in the
+	// parent's children, by nextOlderSibling and prevYoungerSibling, from oldest to youngest
+	struct pcb *oldest = NULL;
+	struct pcb *youngest = NULL;
+	for (int i = 0; i < n; i++) {
+		struct pcb *newProc = allocPcb();
+		struct stackBlock *block = (newProc == NULL) ? NULL : stackPoolGet(stackSize);
+		if (block == NULL) {
+			// give back everything reserved so far
+			if (newProc != NULL) {
+				newProc->nextOlderSibling = freePcbs;
+				freePcbs = newProc;
+			}
+			while (youngest != NULL) {
+				struct pcb *older = youngest->nextOlderSibling;
+				stackPoolRelease(coldOf(youngest)->stackBlock);
+				youngest->nextOlderSibling = freePcbs;
+				freePcbs = youngest;
+				youngest = older;
+			}
+			STAT(kernelStats.sporkFailFull++);
+			leaveKernel(prevPsr);
+			return -1;
+		}
+		coldOf(newProc)->stackBlock = block;
+		newProc->nextOlderSibling = youngest;
+		newProc->prevYoungerSibling = NULL;
+		if (youngest == NULL) {
+			oldest = newProc;
+		}
+		else {
+			youngest->prevYoungerSibling = newProc;
+		}
+		youngest = newProc;
+	}
+
+	// set them up, and chain them for their run queue in the same order
+	int i = 0;
+	for (struct pcb *p = oldest; p != NULL; p = p->prevYoungerSibling) {
+		initProc(p, coldOf(p)->stackBlock, name, func, (args == NULL) ? NULL : args[i], priority);
+		pids[i++] = p->pid;
+		p->prevInQueue = (p == oldest) ? queueTail[priority] : p->nextOlderSibling;
+		p->nextInQueue = p->prevYoungerSibling;
+	}
+
+	// splice them in front of the parent's children
+	oldest->nextOlderSibling = curProc->youngestChild;
+	if (curProc->youngestChild != NULL) {
+		curProc->youngestChild->prevYoungerSibling = oldest;
+	}
+	curProc->youngestChild = youngest;
+	coldOf(curProc)->numChildren += n;
+
+	// add them to the end of their run queue, and run them now if they have a higher priority than the current process
+	if (queueTail[priority] == NULL) {
+		queueHead[priority] = oldest;
+	}
+	else {
+		queueTail[priority]->nextInQueue = oldest;
+	}
+	queueTail[priority] = youngest;
+	readyLevels |= 1 << priority;
+#ifndef PHASE_1A
+	dispatcher();
+#endif
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return 0;
+}
+
+/*
+* void initProc(struct pcb *newProc, struct stackBlock *block, char *name, int(*func)(void *), 
+*	void *arg, int priority) - gives a new child of the current process a slot and pid, fills in
+*	its fields and sets up its context on block. The caller links it into the parent's children
+*	and makes it runnable. The table must have a free slot.
+*	newProc - PCB of the new process, from allocPcb()
+*	block - stack for the new process
+*	name - name of the new process
+*	func - start function of the new process
+*	arg - argument for the new process' start function
+*	priority - priority of the new process
+*/
+void initProc(struct pcb *newProc, struct stackBlock *block, char *name, int(*func)(void *), void *arg, int priority) {
+	// get slot in table; the pid is the next id that maps to that slot, so pid % tableSize == slot
+	int start = nextId % tableSize;
+	int slot = findFreeSlot(start);
+	nextId += (slot - start + tableSize) % tableSize;
+	freeSlots[slot / 64] &= ~(1ULL << (slot % 64));
+	pcbTable[slot] = newProc;
+
+	// define fields
+	struct pcbCold *newCold = coldOf(newProc);
+	newProc->pid = nextId;
+	strcpy(newCold->name, name);
+	newProc->priority = priority;
+	newProc->effectivePriority = priority;
+	newCold->startFunc = func;
+	newCold->arg = arg;
+	newProc->state = 0;
+	newProc->blockReason = 0;
+	newProc->parent = curProc; // set parent to current process
+	newProc->youngestChild = NULL;
+	newCold->deadChildren = NULL;
+	newCold->nextDeadSibling = NULL;
+	newCold->zappers = NULL;
+	newCold->nextZapper = NULL;
+	newCold->zapTarget = NULL;
+	newCold->slot = slot;
+	newCold->numChildren = 0;
+	nextId++;
+
+	// initialize context
+	newCold->stackBlock = block;
+	newCold->context = &block->context;
+	newCold->switches = 0;
+	newCold->cpuTime = 0;
+	newCold->lastDispatch = 0;
+	USLOSS_ContextInit(newCold->context, block->stack, block->size, NULL, &startFuncWrapper);
+
+	// increment number of processes
+	numProcs++;
+	STAT(kernelStats.sporks++);
+#ifndef NO_KERNEL_STATS
+	if (numProcs > kernelStats.peakProcs) {
+		kernelStats.peakProcs = numProcs;
+	}
+#endif
+
+	TRACE(TRACE_SPORK, newProc->pid, curProc->pid, priority);
 }
 
 /*
@@ -172,49 +547,57 @@ int spork(char *name, int(*func)(void *), void *arg, int stackSize, int priority
 */
 int join(int *status) {
 	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call join while in user mode!\n");
-		USLOSS_Halt(1);
-	}
-	unsigned int prevPsr = disableInterrupts();
+	unsigned int prevPsr = enterKernel("join");
 
 	// check invalid arguments passed to the function
 	if ( status == NULL) {
+		leaveKernel(prevPsr);
 		return -3;
 	}
 	
 	// check the process does not have any children
-	if ( curProc->youngestChild == NULL ) {
+	if ( curProc->youngestChild == NULL && coldOf(curProc)->deadChildren == NULL ) {
+		leaveKernel(prevPsr);
 		return -2;
 	}
 
-	// find dead child
-	struct pcb *nextChild = curProc->youngestChild;
-	struct pcb *prevChild = NULL;
-	while (nextChild->state != 2 && nextChild->nextOlderSibling != NULL) {
-		prevChild = nextChild;
-		nextChild = nextChild->nextOlderSibling;
+	// block until a child dies
+	while (coldOf(curProc)->deadChildren == NULL) {
+		curProc->state = 3;
+		curProc->blockReason = JOIN_BLOCK;
+		TRACE(TRACE_BLOCK, curProc->pid, 0, JOIN_BLOCK);
+		if (priorityInheritance) {
+			for (struct pcb *child = curProc->youngestChild; child != NULL; child = child->nextOlderSibling) {
+				donatePriority(child, curProc->effectivePriority);
+			}
+		}
+		dispatcher();
 	}
+
+	// take the most recently terminated child off the dead list
+	struct pcb *nextChild = coldOf(curProc)->deadChildren;
+	coldOf(curProc)->deadChildren = coldOf(nextChild)->nextDeadSibling;
+	coldOf(nextChild)->nextDeadSibling = NULL;
 	
 	// fill status and get pid
-	*status = nextChild->status;
+	*status = coldOf(nextChild)->status;
 	int deadPid = nextChild->pid;
 
-	// remove dead child from list and free the stack
-	if (prevChild == NULL) {
-		curProc->youngestChild = curProc->youngestChild->nextOlderSibling;
-	} 
-	else {
-		prevChild->nextOlderSibling = nextChild->nextOlderSibling;
-	}
-	free(nextChild->context);
+	// its stack was given back to the pool right after it quit
+	coldOf(nextChild)->context = NULL;
 
-	// set pid to -1 and decrement number of processes
+	// set pid to -1, give the slot and PCB back and decrement number of processes
 	nextChild->pid = -1;
+	pcbTable[coldOf(nextChild)->slot] = NULL;
+	freeSlots[coldOf(nextChild)->slot / 64] |= 1ULL << (coldOf(nextChild)->slot % 64);
+	nextChild->nextOlderSibling = freePcbs;
+	freePcbs = nextChild;
 	numProcs--;
+	STAT(kernelStats.joins++);
+	TRACE(TRACE_JOIN, curProc->pid, deadPid, *status);
 
 	// restore interrupts
-	restoreInterrupts(prevPsr);
+	leaveKernel(prevPsr);
 	
 	return deadPid;
 }
@@ -227,113 +610,651 @@ int join(int *status) {
 */
 void quit_phase_1a(int status, int switchToPid) {
 	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call quit_phase_1a while in user mode!\n");
+	unsigned int prevPsr = enterKernel("quit_phase_1a");
+
+	terminate(status);
+
+	// context switch
+	TEMP_switchTo(switchToPid);
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+}
+
+/*
+* void quit(int status) - terminates the current process and runs the next process chosen by 
+*	the dispatcher. If the parent is waiting in join(), it is made runnable, and finds this 
+*	process at the head of its dead children without searching.
+*	status - the status of the process when it's main function returns.
+*/
+void quit(int status) {
+	// make sure in kernel mode and disable interrupts
+	enterKernel("quit");
+
+	terminate(status);
+
+	// context switch; a terminated process is never switched back to
+	dispatcher();
+	USLOSS_Trace("ERROR: Process pid %d ran after it quit.\n", curProc->pid);
+	USLOSS_Halt(1);
+}
+
+/*
+* void zap(int pid) - asks the process with the given PID to quit, and blocks until it does. Any
+*	number of processes can zap the same process; they are all woken when it quits. Returns right
+*	away if the process has already quit but not been joined. Halts if the process is the current
+*	process or init, or doesn't exist.
+*	pid - PID of the process to zap
+*/
+void zap(int pid) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("zap");
+
+	struct pcb *target = lookupPid(pid);
+	if (target == curProc) {
+		USLOSS_Trace("ERROR: Attempt to zap() itself.\n");
 		USLOSS_Halt(1);
 	}
-	unsigned int prevPsr = disableInterrupts();
-
-	
-	// check that all children have been joined
-	if (curProc->youngestChild) {
-		USLOSS_Trace("ERROR: Process pid %d called quit() while it still had children.\n", curProc->pid);
+	if (pid == 1) {
+		USLOSS_Trace("ERROR: Attempt to zap() init.\n");
 		USLOSS_Halt(1);
 	}
+	if (target == NULL) {
+		USLOSS_Trace("ERROR: Attempt to zap() a non-existent process.\n");
+		USLOSS_Halt(1);
+	}
+
+	TRACE(TRACE_ZAP, curProc->pid, pid, 0);
+
+	// wait on the target's list of zappers until it quits
+	if (target->state != 2) {
+		coldOf(curProc)->nextZapper = coldOf(target)->zappers;
+		coldOf(target)->zappers = curProc;
+		coldOf(curProc)->zapTarget = target;
+		curProc->state = 3;
+		curProc->blockReason = ZAP_BLOCK;
+		TRACE(TRACE_BLOCK, curProc->pid, 0, ZAP_BLOCK);
+		if (priorityInheritance) {
+			donatePriority(target, curProc->effectivePriority);
+		}
+		dispatcher();
+	}
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+}
+
+/*
+* int isZapped(void) - returns 1 if another process is waiting in zap() for the current process to
+*	quit, 0 otherwise.
+*/
+int isZapped(void) {
+	requireKernelMode("isZapped");
+	return coldOf(curProc)->zappers != NULL;
+}
+
+/*
+* void terminate(int status) - marks the current process as terminated, moves it to its parent's 
+*	list of dead children and wakes the parent if it is waiting in join(), and every process that
+*	zapped it. Its stack is released
+*	once another process is running. If the process still has children, they are given to init
+*	when orphans are reparented, and it halts otherwise. Must be called with interrupts disabled.
+*	status - the status of the process when it's main function returns.
+*/
+void terminate(int status) {
+	// check that all children have been joined, or give them to init
+	if (curProc->youngestChild || coldOf(curProc)->deadChildren) {
+		if (!reparentOrphans || curProc->parent == NULL) {
+			USLOSS_Trace("ERROR: Process pid %d called quit() while it still had children.\n", curProc->pid);
+			USLOSS_Halt(1);
+		}
+		adoptOrphans(curProc);
+	}
 
 	// save the status and flag as terminated
-	curProc->status = status;
+	coldOf(curProc)->status = status;
 	curProc->state = 2;
+	STAT(kernelStats.quits++);
+	TRACE(TRACE_QUIT, curProc->pid, (curProc->parent == NULL) ? 0 : curProc->parent->pid, status);
 
-	// context switch
-	TEMP_switchTo(switchToPid);
+	// move from the parent's list of live children to its list of dead children; init has no parent
+	struct pcb *parent = curProc->parent;
+	if (parent != NULL) {
+		if (curProc->prevYoungerSibling == NULL) {
+			parent->youngestChild = curProc->nextOlderSibling;
+		}
+		else {
+			curProc->prevYoungerSibling->nextOlderSibling = curProc->nextOlderSibling;
+		}
+		if (curProc->nextOlderSibling != NULL) {
+			curProc->nextOlderSibling->prevYoungerSibling = curProc->prevYoungerSibling;
+		}
+		curProc->nextOlderSibling = NULL;
+		curProc->prevYoungerSibling = NULL;
+		coldOf(parent)->numChildren--;
 
-	// restore interrupts
-	restoreInterrupts(prevPsr);
+		coldOf(curProc)->nextDeadSibling = coldOf(parent)->deadChildren;
+		coldOf(parent)->deadChildren = curProc;
+
+		// wake up the parent if it is waiting in join()
+		if (parent->state == 3 && parent->blockReason == JOIN_BLOCK) {
+			parent->state = 0;
+			parent->blockReason = 0;
+			TRACE(TRACE_WAKE, parent->pid, curProc->pid, 0);
+			enqueue(parent);
+		}
+	}
+
+	// wake up every process waiting in zap()
+	struct pcb *zapper = coldOf(curProc)->zappers;
+	while (zapper != NULL) {
+		struct pcb *next = coldOf(zapper)->nextZapper;
+		coldOf(zapper)->nextZapper = NULL;
+		coldOf(zapper)->zapTarget = NULL;
+		zapper->state = 0;
+		zapper->blockReason = 0;
+		TRACE(TRACE_WAKE, zapper->pid, curProc->pid, 0);
+		enqueue(zapper);
+		zapper = next;
+	}
+	coldOf(curProc)->zappers = NULL;
+
+	// we are still running on this stack, so the next process to run gives it back to the pool
+	deadStack = coldOf(curProc)->stackBlock;
+	coldOf(curProc)->stackBlock = NULL;
 }
 
-// void quit(int status) {
-// 	// make sure in kernel mode and disable interrupts
-// 	checkForKernelMode();
-// 	unsigned int prevPsr = disableInterrupts();
-	
-// 	// context switch
-// 	//TEMP_switchTO(curProc->parent->pid);
+/*
+* void adoptOrphans(struct pcb *proc) - gives all of a process' live and terminated children to 
+*	init. This is not constant time: each list is walked once, to point every child's parent at
+*	init and to find its oldest end, and is then spliced onto the front of init's, so the cost
+*	grows with the number of children. Parents are read directly by quit(), getparent() and 
+*	priority inheritance, so they can't be left pointing at the dead process. Wakes init if it is
+*	waiting in join() and got terminated children. Must be called with interrupts disabled.
+*	proc - the process whose children are given away
+*/
+void adoptOrphans(struct pcb *proc) {
+	struct pcb *init = lookupPid(1);
 
-// 	// restore interrupts
-// 	USLOSS_PsrSet(prevPsr);
-// }
+	// live children
+	if (proc->youngestChild != NULL) {
+		struct pcb *oldest = proc->youngestChild;
+		oldest->parent = init;
+		while (oldest->nextOlderSibling != NULL) {
+			oldest = oldest->nextOlderSibling;
+			oldest->parent = init;
+		}
+		oldest->nextOlderSibling = init->youngestChild;
+		if (init->youngestChild != NULL) {
+			init->youngestChild->prevYoungerSibling = oldest;
+		}
+		init->youngestChild = proc->youngestChild;
+		coldOf(init)->numChildren += coldOf(proc)->numChildren;
+		proc->youngestChild = NULL;
+		coldOf(proc)->numChildren = 0;
+	}
+
+	// terminated children
+	if (coldOf(proc)->deadChildren != NULL) {
+		struct pcb *last = coldOf(proc)->deadChildren;
+		last->parent = init;
+		while (coldOf(last)->nextDeadSibling != NULL) {
+			last = coldOf(last)->nextDeadSibling;
+			last->parent = init;
+		}
+		coldOf(last)->nextDeadSibling = coldOf(init)->deadChildren;
+		coldOf(init)->deadChildren = coldOf(proc)->deadChildren;
+		coldOf(proc)->deadChildren = NULL;
+
+		if (init->state == 3 && init->blockReason == JOIN_BLOCK) {
+			init->state = 0;
+			init->blockReason = 0;
+			TRACE(TRACE_WAKE, init->pid, proc->pid, 0);
+			enqueue(init);
+		}
+	}
+}
+
+/*
+* void donatePriority(struct pcb *proc, int priority) - raises the effective priority of a process
+*	that another process is waiting for, if it is lower than the waiter's. The raise is passed on 
+*	to whatever that process is itself waiting for in join() or zap(), and lasts until it quits.
+*	Must be called with interrupts disabled.
+*	proc - the process being waited for
+*	priority - effective priority of the waiter
+*/
+void donatePriority(struct pcb *proc, int priority) {
+	if (proc->state == 2 || proc->effectivePriority <= priority) {
+		return;
+	}
+
+	// a runnable process moves to the run queue for its new priority
+	if (proc->state == 0) {
+		dequeue(proc);
+		proc->effectivePriority = priority;
+		enqueue(proc);
+	}
+	else {
+		proc->effectivePriority = priority;
+	}
+
+	if (proc->state == 3 && proc->blockReason == JOIN_BLOCK) {
+		for (struct pcb *child = proc->youngestChild; child != NULL; child = child->nextOlderSibling) {
+			donatePriority(child, priority);
+		}
+	}
+	else if (proc->state == 3 && proc->blockReason == ZAP_BLOCK) {
+		donatePriority(coldOf(proc)->zapTarget, priority);
+	}
+}
 
 /*
-* int getpid(void) - returns the PID of the currently running process.
+* int getpid(void) - returns the PID of the currently running process. Like the other read-only
+*	queries it doesn't touch the interrupt bit, but it still reads the PSR to check for kernel mode:
+*	neither the pid nor the mode is cached, since a process drops to user mode with USLOSS_PsrSet()
+*	without the kernel seeing it, and a cached flag would let it call in from user mode.
 */
 int getpid(void) {
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call getpid while in user mode!\n");
+	requireKernelMode("getpid");
+	return curProc->pid;
+}
+
+/*
+* int getpriority(void) - returns the priority the current process was created with, which
+*	priority inheritance doesn't change.
+*/
+int getpriority(void) {
+	requireKernelMode("getpriority");
+	return curProc->priority;
+}
+
+/*
+* int getstate(int pid) - returns the state of the process with the given PID, as shown by
+*	dumpProcesses(): 0 Runnable, 1 Running, 2 Terminated, 3 Blocked. Returns -1 if there is no
+*	such process. This leaves interrupts enabled, so it doesn't write the PSR; if a context switch
+*	happens while it reads the table, it reads it again.
+*	pid - PID of the process
+*/
+int getstate(int pid) {
+	requireKernelMode("getstate");
+	unsigned int seq;
+	int state;
+	do {
+		seq = switchCount;
+		struct pcb *p = peekPid(pid, seq);
+		state = (p == NULL) ? -1 : p->state;
+		KERNEL_BARRIER();
+	} while (switchCount != seq);
+	return state;
+}
+
+/*
+* int getparent(int pid) - returns the PID of the parent of the process with the given PID, 0 for 
+*	init, or -1 if there is no such process. Reads the table the same way as getstate().
+*	pid - PID of the process
+*/
+int getparent(int pid) {
+	requireKernelMode("getparent");
+	unsigned int seq;
+	int ppid;
+	do {
+		seq = switchCount;
+		struct pcb *p = peekPid(pid, seq);
+		ppid = (p == NULL) ? -1 : (p->parent == NULL) ? 0 : p->parent->pid;
+		KERNEL_BARRIER();
+	} while (switchCount != seq);
+	return ppid;
+}
+
+
+/*
+* int blockMe(int reason) - blocks the current process until another process calls unblockProc()
+*	on it, and runs the next process chosen by the dispatcher. The process is not on any run queue
+*	while it is blocked, so blocking and unblocking take the same time no matter how many processes
+*	there are. Halts if the reason is reserved for phase 1. Returns 0 once the process is unblocked.
+*	reason - why the process is blocked, shown by dumpProcesses(); must be greater than 10
+*/
+int blockMe(int reason) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("blockMe");
+
+	if (reason <= MAX_KERNEL_BLOCK) {
+		USLOSS_Trace("ERROR: Process pid %d called blockMe() with reserved reason %d.\n", curProc->pid, reason);
 		USLOSS_Halt(1);
 	}
-	return curProc->pid;
+
+	curProc->state = 3;
+	curProc->blockReason = reason;
+	TRACE(TRACE_BLOCK, curProc->pid, 0, reason);
+	dispatcher();
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return 0;
+}
+
+/*
+* int unblockProc(int pid) - makes a process that blocked itself with blockMe() runnable again,
+*	and runs it now if it has a higher priority than the current process. Returns -2 if there is
+*	no such process or it isn't blocked in blockMe(), 0 otherwise.
+*	pid - PID of the process to unblock
+*/
+int unblockProc(int pid) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("unblockProc");
+
+	struct pcb *p = lookupPid(pid);
+	if (p == NULL || p->state != 3 || p->blockReason <= MAX_KERNEL_BLOCK) {
+		leaveKernel(prevPsr);
+		return -2;
+	}
+
+	p->state = 0;
+	p->blockReason = 0;
+	TRACE(TRACE_WAKE, p->pid, curProc->pid, 0);
+	enqueue(p);
+	dispatcher();
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return 0;
+}
+
+/*
+* int getChildCount(int pid) - returns the number of live children of the process with the given
+*	PID, not counting children that have quit but not been joined, or -1 if there is no such process.
+*	pid - PID of the parent
+*/
+int getChildCount(int pid) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("getChildCount");
+
+	struct pcb *p = lookupPid(pid);
+	int count = (p == NULL) ? -1 : coldOf(p)->numChildren;
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return count;
 }
 
+/*
+* int getProcessSnapshot(struct procInfo *buf, int max) - copies the PID, parent's PID, name, 
+*	priority, state, status and block reason of up to max processes into buf, in one pass over 
+*	the table with interrupts disabled, and returns how many were copied.
+*	buf - array to fill
+*	max - number of entries in buf
+*/
+int getProcessSnapshot(struct procInfo *buf, int max) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("getProcessSnapshot");
+
+	int count = 0;
+	for (int i = 0; i < tableSize && count < max; i++) {
+		struct pcb *p = pcbTable[i];
+		if (p != NULL) {
+			struct procInfo *info = &buf[count++];
+			info->pid = p->pid;
+			info->ppid = (p->parent == NULL) ? 0 : p->parent->pid; // make ppid 0 if process it init
+			info->priority = p->priority;
+			info->effectivePriority = p->effectivePriority;
+			info->state = p->state;
+			info->status = coldOf(p)->status;
+			info->blockReason = p->blockReason;
+			strcpy(info->name, coldOf(p)->name);
+		}
+	}
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return count;
+}
 
 /*
 * void dumpProcesses(void) - prints out process infromation from the process table, in a human-readable format. 
+*	The table is copied with getProcessSnapshot(), and the whole dump is printed with one console 
+*	write, so it isn't interleaved with other output and interrupts aren't held off while formatting.
 */
 void dumpProcesses(void) {
-	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call dumpProcesses while in user mode!\n");
-		USLOSS_Halt(1);
-	};
-	unsigned int prevPsr = disableInterrupts();
+	requireKernelMode("dumpProcesses");
+
+	// room for every process, plus a header line; each line fits in DUMP_LINE_SIZE
+	int max = numProcs;
+	struct procInfo *procs = malloc(max * sizeof(struct procInfo));
+	char *out = malloc((max + 1) * DUMP_LINE_SIZE);
+	if (procs == NULL || out == NULL) {
+		USLOSS_Trace("ERROR: Could not allocate memory to dump %d processes\n", max);
+		free(procs);
+		free(out);
+		return;
+	}
+	int count = getProcessSnapshot(procs, max);
 
 	// header
-	USLOSS_Console("%4s %5s  %-17s %-9s %s\n", "PID", "PPID", "NAME", "PRIORITY", "STATE");
-	
+	int len = sprintf(out, "%4s %5s  %-17s %-9s %s\n", "PID", "PPID", "NAME", "PRIORITY", "STATE");
+
 	// processes
-	for (int i = 0; i < MAXPROC; i++) {
-		struct pcb p = pcbTable[i];
-		if (p.pid != -1) {
-			int ppid = (p.pid == 1) ? 0 : p.parent->pid; // make ppid 0 if process it init
-			USLOSS_Console("%4d %5d  %-17s %-9d %s", p.pid, ppid, p.name, p.priority, stateArr[p.state]);
-			// print the status if terminated
-			if (p.state == 2) {
-				USLOSS_Console("(%d)", p.status);
-			}
-			USLOSS_Console("\n");
+	for (int i = 0; i < count; i++) {
+		struct procInfo *p = &procs[i];
+		// a priority raised by priority inheritance is shown as priority(effective priority)
+		char priority[24];
+		if (p->effectivePriority == p->priority) {
+			sprintf(priority, "%d", p->priority);
+		}
+		else {
+			sprintf(priority, "%d(%d)", p->priority, p->effectivePriority);
+		}
+		len += sprintf(out + len, "%4d %5d  %-17s %-9s %s", p->pid, p->ppid, p->name, priority, stateArr[p->state]);
+		// print the status if terminated, or the reason if blocked in blockMe()
+		if (p->state == 2) {
+			len += sprintf(out + len, "(%d)", p->status);
+		}
+		else if (p->state == 3 && p->blockReason > MAX_KERNEL_BLOCK) {
+			len += sprintf(out + len, "(%d)", p->blockReason);
+		}
+		len += sprintf(out + len, "\n");
+	}
+
+	USLOSS_Console("%s", out);
+	free(procs);
+	free(out);
+}
+
+/*
+* struct kernelStats getKernelStats(void) - returns a copy of the kernel's counters. They are all 0
+*	if the kernel was compiled with -DNO_KERNEL_STATS.
+*/
+struct kernelStats getKernelStats(void) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("getKernelStats");
+
+	struct kernelStats stats = kernelStats;
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return stats;
+}
+
+/*
+* void dumpStats(void) - prints out the kernel's counters, and how many times each process has been
+*	switched to, in a human-readable format. The PSR call count is left out, since it changes 
+*	whenever a kernel path is tuned; it is in getKernelStats(), and bench06 reports it.
+*/
+void dumpStats(void) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("dumpStats");
+
+#ifdef NO_KERNEL_STATS
+	USLOSS_Console("Kernel statistics were compiled out (NO_KERNEL_STATS)\n");
+#else
+	struct kernelStats *k = &kernelStats;
+	USLOSS_Console("%-30s %ld\n", "sporks", k->sporks);
+	USLOSS_Console("%-30s %ld\n", "sporks failed, table full", k->sporkFailFull);
+	USLOSS_Console("%-30s %ld\n", "sporks failed, stack too small", k->sporkFailStack);
+	USLOSS_Console("%-30s %ld\n", "sporks failed, invalid args", k->sporkFailInvalid);
+	USLOSS_Console("%-30s %ld\n", "joins", k->joins);
+	USLOSS_Console("%-30s %ld\n", "quits", k->quits);
+	USLOSS_Console("%-30s %ld\n", "context switches", k->contextSwitches);
+	USLOSS_Console("%-30s %ld\n", "slot probes", k->slotProbes);
+	USLOSS_Console("%-30s %d\n", "longest slot probe", k->maxSlotProbe);
+	USLOSS_Console("%-30s %d\n", "peak processes", k->peakProcs);
+
+	// context switches per process
+	USLOSS_Console("%4s  %s\n", "PID", "SWITCHES");
+	for (int i = 0; i < tableSize; i++) {
+		struct pcb *p = pcbTable[i];
+		if (p != NULL) {
+			USLOSS_Console("%4d  %d\n", p->pid, coldOf(p)->switches);
+		}
+	}
+#endif
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+}
+
+/*
+* int readtime(void) - returns the number of microseconds the current process has spent running,
+*	including its current time slice.
+*/
+int readtime(void) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("readtime");
+
+	int time = coldOf(curProc)->cpuTime + readClock() - curStartTime;
+
+	// restore interrupts
+	leaveKernel(prevPsr);
+	return time;
+}
+
+/*
+* int setTimeSlice(int ms) - sets how long a process can run before the dispatcher lets the next 
+*	process of the same priority run. Returns -1 if ms is negative, 0 otherwise.
+*	ms - length of a time slice in milliseconds, or 0 to never take the CPU from a process
+*		because of time
+*/
+int setTimeSlice(int ms) {
+	requireKernelMode("setTimeSlice");
+	if (ms < 0) {
+		return -1;
+	}
+	timeSlice = ms;
+	return 0;
+}
+
+/*
+* int setPriorityInheritance(int on) - turns priority inheritance on or off. When it is on, a 
+*	process that waits in join() or zap() raises the effective priority of the processes it waits 
+*	for to its own, so a high priority process isn't held up by a middle priority one while a low
+*	priority child it is waiting for never runs. Returns the previous setting.
+*	on - 1 to turn priority inheritance on, 0 to turn it off
+*/
+int setPriorityInheritance(int on) {
+	requireKernelMode("setPriorityInheritance");
+	int prev = priorityInheritance;
+	priorityInheritance = (on != 0);
+	return prev;
+}
+
+/*
+* int setReparentOrphans(int on) - chooses what happens when a process quits while it still has
+*	children. By default that halts the simulation; when this is turned on, the children, live 
+*	or terminated, are given to init, which joins them. Giving them away takes time proportional
+*	to how many there are; see adoptOrphans(). Returns the previous setting.
+*	on - 1 to give orphans to init, 0 to halt
+*/
+int setReparentOrphans(int on) {
+	requireKernelMode("setReparentOrphans");
+	int prev = reparentOrphans;
+	reparentOrphans = (on != 0);
+	return prev;
+}
+
+/*
+* int readCurStartTime(void) - returns the clock time, in microseconds, when the current process 
+*	was last switched to.
+*/
+int readCurStartTime(void) {
+	requireKernelMode("readCurStartTime");
+	return curStartTime;
+}
+
+/*
+* void dumpCpuTimes(void) - prints out how many times each process has been switched to, when it was 
+*	last switched to and how much CPU time it has used, in a human-readable format. This is separate 
+*	from dumpProcesses() so that the format of that stays the same.
+*/
+void dumpCpuTimes(void) {
+	// make sure in kernel mode and disable interrupts
+	unsigned int prevPsr = enterKernel("dumpCpuTimes");
+
+	int now = readClock();
+
+	// header
+	USLOSS_Console("%4s  %-17s %-9s %-13s %s\n", "PID", "NAME", "SWITCHES", "LAST_DISPATCH", "CPU(us)");
+
+	// processes; the running one is charged for its current time slice
+	for (int i = 0; i < tableSize; i++) {
+		struct pcb *p = pcbTable[i];
+		if (p != NULL) {
+			struct pcbCold *cold = coldOf(p);
+			int cpuTime = (p == curProc) ? cold->cpuTime + now - curStartTime : cold->cpuTime;
+			USLOSS_Console("%4d  %-17s %-9d %-13d %d\n", p->pid, cold->name, cold->switches, cold->lastDispatch, cpuTime);
 		}
 	}
 
 	// restore interrupts
-	restoreInterrupts(prevPsr);
+	leaveKernel(prevPsr);
 }
 
 /*
-* void TEMP_switchTo(int pid) - Context switches to the process with the given PID.
+* void TEMP_switchTo(int pid) - Context switches to the process with the given PID. A blocked 
+*	process can only be resumed by whatever it is waiting for, so if the process is blocked the
+*	dispatcher chooses what runs instead. Halts if there is no such process, or if it has quit but
+*	not been joined: its stack has gone back to the pool, so there is no context left to resume.
 *	pid - PID of the proccess to switch to.
 */
 void TEMP_switchTo(int pid) {
 	// make sure in kernel mode and disable interrupts
-	if (checkForKernelMode() == 0) {
-		USLOSS_Trace("ERROR: Someone attempted to call TEMP_switchTo while in user mode!\n");
-		USLOSS_Halt(1);
-	};
-	unsigned int prevPsr = disableInterrupts();
+	unsigned int prevPsr = enterKernel("TEMP_switchTo");
 	
 	// switch to new process with given pid
-	int slot = pid % MAXPROC;
-	struct pcb *oldProc = curProc;
-	curProc = &pcbTable[slot];
-	curProc->state = 1; // set new to Running
+	struct pcb *newProc = lookupPid(pid);
+	if (newProc == NULL) {
+		USLOSS_Trace("ERROR: TEMP_switchTo() called with pid %d, which doesn't exist.\n", pid);
+		USLOSS_Halt(1);
+	}
+	if (newProc->state == 2) {
+		USLOSS_Trace("ERROR: TEMP_switchTo() called with pid %d, which has already quit.\n", pid);
+		USLOSS_Halt(1);
+	}
+	if (newProc->state == 3) {
+		dispatcher();
+		leaveKernel(prevPsr);
+		return;
+	}
 
-	if (pid == 1) { // don't store old proc on first process
-		USLOSS_ContextSwitch(NULL, curProc->context);
-	} else {
-		oldProc->state = (oldProc->state == 2) ? 2 : 0; // set old to Runnable if not terminated
-		USLOSS_ContextSwitch(oldProc->context, curProc->context);
+	// the switch is recorded, or checked against the schedule being replayed
+	if (schedLogMode == SCHED_LOG_RECORD) {
+		int now = readClock();
+		schedLogRecord(SCHED_SWITCH, pid, now, now - curStartTime, preemptionPoints);
 	}
+	else if (schedLogMode == SCHED_LOG_REPLAY && schedLogPeek() != NULL) {
+		struct schedDecision *d = schedLogPeek();
+		if (d->reason != SCHED_SWITCH || d->pid != pid) {
+			USLOSS_Trace("ERROR: Replay diverged: TEMP_switchTo(%d) called, but the log has pid %d, reason %d.\n", pid, d->pid, d->reason);
+			USLOSS_Halt(1);
+		}
+		schedLogNext();
+	}
+
+	if (newProc->state == 0) {
+		dequeue(newProc);
+	}
+	switchTo(newProc);
 
 	// restore interrupts
-	restoreInterrupts(prevPsr);
+	leaveKernel(prevPsr);
 }
 
 /*
@@ -341,10 +1262,12 @@ void TEMP_switchTo(int pid) {
 * 	start function of the current process, then quit() if that function returns.
 */
 void startFuncWrapper(void) {
-	int (*startFunc)(void *) = curProc->startFunc;
-	void *arg = curProc -> arg;
+	releaseDeadStack();
+	int (*startFunc)(void *) = coldOf(curProc)->startFunc;
+	void *arg = coldOf(curProc)->arg;
 	
 	// enable interrupts before calling start function
+	STAT(kernelStats.psrCalls += 2);
 	unsigned int prevPsr = USLOSS_PsrGet();
 	if (USLOSS_PsrSet(prevPsr | USLOSS_PSR_CURRENT_INT) == USLOSS_ERR_INVALID_PSR) {
 		USLOSS_Trace("ERROR: Invalid PSR");
@@ -353,7 +1276,11 @@ void startFuncWrapper(void) {
 
 	// cal start function and quit when it returns
 	int status = (*startFunc)(arg);
+#ifdef PHASE_1A
 	quit_phase_1a(status, curProc->parent->pid);
+#else
+	quit(status);
+#endif
 }
 
 /*
@@ -370,14 +1297,14 @@ int startFuncInit(void *) {
 	USLOSS_Console("Phase 1A TEMPORARY HACK: init() manually switching to testcase_main() after using spork() to create it.\n");
 	TEMP_switchTo(2); // only for phase1a - manually switch to testcase_main
 
-	// int joinVal = 0;
-	// int zero = 0;
-	// int *joinStatus = &zero;
-	// while (joinVal != -2) {
-	// 	joinVal = join(joinStatus);
-	// }
+	// only runs if every other process is blocked; clean up children, including orphans given to
+	// init, until there are none left
+	int joinStatus;
+	while (join(&joinStatus) != -2) {
+	}
 
-	// USLOSS_Trace("ERROR: init process has no children\n");
+	USLOSS_Trace("ERROR: init process has no children\n");
+	USLOSS_Halt(1);
 	return 1;
 }
 
@@ -395,39 +1322,482 @@ int testcase_mainWrapper(void *) {
 }
 
 /*
-* int checkForKernelMode(void) - returns 0 if not in kernel mode
+* int findFreeSlot(int start) - returns the first free slot in pcbTable at or after start, wrapping
+*	around to the beginning of the table. Uses a find-first-set on each 64-slot word of the free slot
+*	bitmap, so it never has to look at the PCBs themselves. The table must not be full.
+*	start - the slot to start searching from
 */
-int checkForKernelMode(void) {
-	// check if not in kernel mode
-	return (USLOSS_PSR_CURRENT_MODE & USLOSS_PsrGet()); 
+int findFreeSlot(int start) {
+	int numWords = (tableSize + 63) / 64;
+	int word = start / 64;
+	unsigned long long bits = freeSlots[word] & (~0ULL << (start % 64));
+	for (int i = 0; i <= numWords; i++) {
+		if (bits != 0) {
+#ifndef NO_KERNEL_STATS
+			kernelStats.slotProbes += i + 1;
+			if (i + 1 > kernelStats.maxSlotProbe) {
+				kernelStats.maxSlotProbe = i + 1;
+			}
+#endif
+			return word * 64 + __builtin_ctzll(bits);
+		}
+		word = (word + 1) % numWords;
+		bits = freeSlots[word];
+	}
+	return -1;
+}
+
+/*
+* int initTable(int size) - allocates an empty pcbTable with the given number of slots. Returns -1
+*	if out of memory, 0 otherwise.
+*	size - the number of slots
+*/
+int initTable(int size) {
+	int numWords = (size + 63) / 64;
+	pcbTable = calloc(size, sizeof(struct pcb *));
+	freeSlots = malloc(numWords * sizeof(unsigned long long));
+	if (pcbTable == NULL || freeSlots == NULL) {
+		free(pcbTable);
+		free(freeSlots);
+		return -1;
+	}
+
+	// mark every slot as free
+	for (int i = 0; i < numWords; i++) {
+		freeSlots[i] = ~0ULL;
+	}
+	if (size % 64 != 0) {
+		freeSlots[numWords - 1] = (1ULL << (size % 64)) - 1;
+	}
+	tableSize = size;
+	return 0;
+}
+
+/*
+* int growTable(void) - doubles the number of slots in pcbTable and moves every process to slot
+*	pid % tableSize. No two processes can land in the same slot, since pids that were different
+*	mod the old size are still different mod twice that size. The PCBs themselves don't move, and
+*	the old table is kept in retiredTables for readers that still have it. Returns -1 if out of
+*	memory, 0 otherwise.
+*/
+int growTable(void) {
+	struct pcb **oldTable = pcbTable;
+	unsigned long long *oldFreeSlots = freeSlots;
+	int oldSize = tableSize;
+
+	if (numRetiredTables == MAX_RETIRED_TABLES || initTable(oldSize * 2) == -1) {
+		pcbTable = oldTable;
+		freeSlots = oldFreeSlots;
+		return -1;
+	}
+
+	for (int i = 0; i < oldSize; i++) {
+		struct pcb *p = oldTable[i];
+		if (p != NULL) {
+			coldOf(p)->slot = p->pid % tableSize;
+			pcbTable[coldOf(p)->slot] = p;
+			freeSlots[coldOf(p)->slot / 64] &= ~(1ULL << (coldOf(p)->slot % 64));
+		}
+	}
+	retiredTables[numRetiredTables++] = oldTable;
+	free(oldFreeSlots);
+	return 0;
 }
 
 /*
-* unsigned int disableInterrupts(void) - sets interrupts to disabled and returns the previous state
-*	of the PSR.
+* struct pcb *allocPcb(void) - returns an unused PCB, allocating a new page of them if there
+*	are none left. A page is one allocation aligned to PCB_PAGE_BYTES: an array of hot halves,
+*	followed by an array of the matching cold halves. Returns NULL if out of memory.
 */
-unsigned int disableInterrupts(void) {
+struct pcb *allocPcb(void) {
+	if (freePcbs == NULL) {
+		// aligned_alloc() needs the size to be a multiple of the alignment
+		size_t size = PCB_PAGE_BYTES + PCB_PAGE_SIZE * sizeof(struct pcbCold);
+		size = (size + PCB_PAGE_BYTES - 1) / PCB_PAGE_BYTES * PCB_PAGE_BYTES;
+		struct pcb *page = aligned_alloc(PCB_PAGE_BYTES, size);
+		if (page == NULL) {
+			return NULL;
+		}
+		for (int i = 0; i < PCB_PAGE_SIZE; i++) {
+			page[i].pid = -1;
+			page[i].nextOlderSibling = (i + 1 < PCB_PAGE_SIZE) ? &page[i + 1] : NULL;
+		}
+		freePcbs = page;
+	}
+
+	struct pcb *p = freePcbs;
+	freePcbs = p->nextOlderSibling;
+	p->nextOlderSibling = NULL;
+	return p;
+}
+
+/*
+* struct pcbCold *coldOf(struct pcb *proc) - returns the fields of a process that aren't needed
+*	for scheduling. They are at the same index in the cold array of the PCB's page, which starts
+*	right after the hot array, so the hot half doesn't need a pointer to them.
+*	proc - the process
+*/
+struct pcbCold *coldOf(struct pcb *proc) {
+	struct pcb *page = (struct pcb *)((uintptr_t)proc & ~(uintptr_t)(PCB_PAGE_BYTES - 1));
+	struct pcbCold *coldPage = (struct pcbCold *)(page + PCB_PAGE_SIZE);
+	return &coldPage[proc - page];
+}
+
+/*
+* struct pcb *lookupPid(int pid) - returns the process with the given PID, or NULL if there is none.
+*	A pid is its slot plus a multiple of tableSize, the slot's generation, so the process can only
+*	be in slot pid % tableSize; once it has been joined, the slot is either empty or holds a
+*	process from a later generation with a different pid.
+*	pid - the PID to look up
+*/
+struct pcb *lookupPid(int pid) {
+	if (pid <= 0) {
+		return NULL;
+	}
+	struct pcb *p = pcbTable[pid % tableSize];
+	if (p == NULL || p->pid != pid) {
+		return NULL;
+	}
+	return p;
+}
+
+/*
+* struct pcb *peekPid(int pid, unsigned int seq) - lookupPid() for callers that leave interrupts
+*	enabled. Another process may grow the table whenever there is a context switch, so this may
+*	read a table that has been replaced; growTable() never frees them, and PCBs are never freed
+*	either, so every read stays in memory the kernel owns. What is read may be out of date, though,
+*	so the caller must check switchCount again after reading the PCB and retry if it has changed.
+*	Returns NULL if there is no such process or there has been a switch.
+*	pid - the PID to look up
+*	seq - switchCount when the caller started
+*/
+struct pcb *peekPid(int pid, unsigned int seq) {
+	if (pid <= 0) {
+		return NULL;
+	}
+	// read the size first, so it is never bigger than the table read after it, which keeps the
+	// index in bounds. The barriers make every call read them again, instead of using what a call
+	// before a switch read
+	KERNEL_BARRIER();
+	int size = tableSize;
+	KERNEL_BARRIER();
+	struct pcb **table = pcbTable;
+	struct pcb *p = table[pid % size];
+	KERNEL_BARRIER();
+	if (switchCount != seq || p == NULL || p->pid != pid) {
+		return NULL;
+	}
+	return p;
+}
+
+/*
+* int readClock(void) - returns the current time in microseconds, read from the clock device.
+*/
+int readClock(void) {
+	int now;
+	if (USLOSS_DeviceInput(USLOSS_CLOCK_DEV, 0, &now) != USLOSS_DEV_OK) {
+		USLOSS_Trace("ERROR: Could not read the clock device");
+		USLOSS_Halt(1);
+	}
+	return now;
+}
+
+/*
+* void requireKernelMode(char *func) - halts if the CPU is not in kernel mode. Used by kernel
+*	functions that don't need interrupts disabled.
+*	func - name of the function being called, for the error message
+*/
+void requireKernelMode(char *func) {
+	STAT(kernelStats.psrCalls++);
+	unsigned int psr = USLOSS_PsrGet();
+	if ((psr & USLOSS_PSR_CURRENT_MODE) == 0) {
+		USLOSS_Trace("ERROR: Someone attempted to call %s while in user mode!\n", func);
+		USLOSS_Halt(1);
+	}
+	if (psr & USLOSS_PSR_CURRENT_INT) {
+		if (schedLogMode == SCHED_LOG_REPLAY) {
+			// a logged preemption may be made here, which needs interrupts disabled
+			leaveKernel(enterKernel(func));
+		}
+		else {
+			// one instruction, so a clock interrupt sees the count either before or after it
+			__atomic_add_fetch(&preemptionPoints, 1, __ATOMIC_RELAXED);
+		}
+	}
+}
+
+/*
+* unsigned int enterKernel(char *func) - halts if the CPU is not in kernel mode, then disables 
+*	interrupts and returns the previous state of the PSR, to be passed to leaveKernel() on every
+*	path out of the function. The PSR is read once. When interrupts are already disabled, as they
+*	are when one kernel function calls another, the PSR is left alone.
+*	func - name of the function being called, for the error message
+*/
+unsigned int enterKernel(char *func) {
+	STAT(kernelStats.psrCalls++);
 	unsigned int prevPsr = USLOSS_PsrGet();
-	if (USLOSS_PsrSet(prevPsr & ~USLOSS_PSR_CURRENT_INT) == USLOSS_ERR_INVALID_PSR) {
-		USLOSS_Trace("ERROR: Invalid PSR");
+	if ((prevPsr & USLOSS_PSR_CURRENT_MODE) == 0) {
+		USLOSS_Trace("ERROR: Someone attempted to call %s while in user mode!\n", func);
 		USLOSS_Halt(1);
 	}
+	if (prevPsr & USLOSS_PSR_CURRENT_INT) {
+		STAT(kernelStats.psrCalls++);
+		if (USLOSS_PsrSet(prevPsr & ~USLOSS_PSR_CURRENT_INT) == USLOSS_ERR_INVALID_PSR) {
+			USLOSS_Trace("ERROR: Invalid PSR");
+			USLOSS_Halt(1);
+		}
+		preemptionPoint();
+	}
 	return prevPsr;
 }
 
 /*
-* void restoreInterrupts(unsigned int prevPsr) - restores the state of interrupts to its
-*	previous value, as passed by prevPsr
-*	prevPsr - the previous value of the psr to restore to
+* void leaveKernel(unsigned int prevPsr) - re-enables interrupts if they were enabled when the
+*	matching enterKernel() was called. Otherwise they are still disabled, and the PSR is left alone.
+*	prevPsr - the value returned by enterKernel()
 */
-void restoreInterrupts(unsigned int prevPsr) {
-	if (USLOSS_PsrSet(prevPsr) == USLOSS_ERR_INVALID_PSR) {
-		USLOSS_Trace("ERROR: Invalid PSR");
+void leaveKernel(unsigned int prevPsr) {
+	if (prevPsr & USLOSS_PSR_CURRENT_INT) {
+		STAT(kernelStats.psrCalls++);
+		if (USLOSS_PsrSet(prevPsr) == USLOSS_ERR_INVALID_PSR) {
+			USLOSS_Trace("ERROR: Invalid PSR");
+			USLOSS_Halt(1);
+		}
+	}
+}
+
+/*
+* void dispatcher(void) - switches to the highest priority runnable process, unless the current
+*	process is still running and has a higher priority, or the same priority and time left in its
+*	time slice. Processes of the same priority run in the order they became runnable. The queue 
+*	to run from is found with a find-first-set on readyLevels, so this takes the same time no 
+*	matter how many processes are runnable. Must be called with interrupts disabled.
+*/
+void dispatcher(void) {
+	dispatchFor(SCHED_DISPATCH);
+}
+
+/*
+* void dispatchFor(int reason) - runs the process chosen by chooseNext(), or the next one in the
+*	schedule being replayed, and records the decision when recording. Must be called with 
+*	interrupts disabled.
+*	reason - SCHED_DISPATCH, or SCHED_PREEMPT when called by the clock handler
+*/
+void dispatchFor(int reason) {
+	if (schedLogMode == SCHED_LOG_REPLAY && replayDecision(reason)) {
+		return;
+	}
+
+	struct pcb *newProc = chooseNext();
+	if (schedLogMode == SCHED_LOG_RECORD) {
+		int now = readClock();
+		schedLogRecord(reason, (newProc == NULL) ? curProc->pid : newProc->pid, now, now - curStartTime, preemptionPoints);
+	}
+
+	if (newProc != NULL) {
+		dequeue(newProc);
+		switchTo(newProc);
+	}
+}
+
+/*
+* struct pcb *chooseNext(void) - returns the process the dispatcher should switch to, or NULL if 
+*	the current process should keep running. Halts if no process can run.
+*/
+struct pcb *chooseNext(void) {
+	if (readyLevels == 0) {
+		if (curProc->state == 1) {
+			return NULL;
+		}
+		USLOSS_Trace("ERROR: No runnable processes left; pid %d is %s.\n", curProc->pid, stateArr[curProc->state]);
 		USLOSS_Halt(1);
 	}
+
+	// highest priority is the lowest set bit
+	int priority = __builtin_ctz(readyLevels);
+	if (curProc->state == 1 && (curProc->effectivePriority < priority || (curProc->effectivePriority == priority && !timeSliceOver()))) {
+		return NULL;
+	}
+	return queueHead[priority];
 }
 
+/*
+* int replayDecision(int reason) - makes the next decision in the schedule being replayed: keeps 
+*	the current process running or switches to the logged one, ignoring priorities and time 
+*	slices. Returns 0 if the log has run out, so the dispatcher should decide live, 1 otherwise.
+*	Halts if the run has diverged from the log.
+*	reason - why the dispatcher was called
+*/
+int replayDecision(int reason) {
+	struct schedDecision *d = schedLogPeek();
+	if (d == NULL) {
+		return 0;
+	}
+
+	struct pcb *newProc = lookupPid(d->pid);
+	if (d->reason != reason || newProc == NULL || (newProc == curProc ? newProc->state != 1 : newProc->state != 0)) {
+		USLOSS_Trace("ERROR: Replay diverged: the log has pid %d, reason %d, but the dispatcher was called with reason %d and that pid is %s.\n", 
+			d->pid, d->reason, reason, (newProc == NULL) ? "gone" : stateArr[newProc->state]);
+		USLOSS_Halt(1);
+	}
+	schedLogNext();
 
-//void dispatcher() {} for phase1b
+	if (newProc != curProc) {
+		dequeue(newProc);
+		switchTo(newProc);
+	}
+	return 1;
+}
+
+/*
+* void clockHandler(int dev, void *arg) - handler for clock interrupts. When the running process
+*	has used up its time slice, lets the dispatcher run the next process of the same priority.
+*	When replaying, the clock preempts nothing; logged preemptions are made by preemptionPoint().
+*	dev - the device that interrupted
+*	arg - unused
+*/
+void clockHandler(int dev, void *arg) {
+	if (curProc == NULL || curProc->state != 1) {
+		return;
+	}
+	if (schedLogMode == SCHED_LOG_REPLAY && schedLogPeek() != NULL) {
+		return;
+	}
+	if (timeSliceOver()) {
+		dispatchFor(SCHED_PREEMPT);
+	}
+}
+
+/*
+* void preemptionPoint(void) - counts a kernel entry made with interrupts enabled. The clock can
+*	only interrupt the running process between such entries, so the count at a preemption says 
+*	where in the process it happened, the same way every time the process runs; how long it had
+*	been running does not. When replaying, makes the next logged preemption if it happened just 
+*	before this entry, and halts if the process has gone past it. Must be called with interrupts
+*	disabled.
+*/
+void preemptionPoint(void) {
+	if (schedLogMode == SCHED_LOG_REPLAY) {
+		struct schedDecision *d = schedLogPeek();
+		if (d != NULL && d->reason == SCHED_PREEMPT) {
+			if (d->points < preemptionPoints) {
+				USLOSS_Trace("ERROR: Replay diverged: the log has pid %d preempted after %d kernel entries, but it has made %d.\n", 
+					curProc->pid, d->points, preemptionPoints);
+				USLOSS_Halt(1);
+			}
+			if (d->points == preemptionPoints) {
+				dispatchFor(SCHED_PREEMPT);
+			}
+		}
+	}
+	preemptionPoints++;
+}
+
+/*
+* int timeSliceOver(void) - returns 1 if the current process has run for at least a time slice 
+*	since it was switched to, 0 if it hasn't or if there is no time slicing.
+*/
+int timeSliceOver(void) {
+	return timeSlice > 0 && readClock() - curStartTime >= timeSlice * 1000;
+}
+
+/*
+* void switchTo(struct pcb *newProc) - context switches from the current process to newProc, which
+*	must not be on a run queue. The current process goes to the back of its run queue if it
+*	was running. Must be called with interrupts disabled.
+*	newProc - the process to switch to
+*/
+void switchTo(struct pcb *newProc) {
+	struct pcb *oldProc = curProc;
+	curProc = newProc;
+	curProc->state = 1; // set new to Running
+	if (oldProc != newProc) {
+		switchCount++;
+		preemptionPoints = 0;
+		STAT(kernelStats.contextSwitches++);
+		STAT(coldOf(newProc)->switches++);
+
+		// charge the old process for its time slice and start the new one's
+		int now = readClock();
+		if (oldProc != NULL) {
+			coldOf(oldProc)->cpuTime += now - curStartTime;
+		}
+		coldOf(newProc)->lastDispatch = now;
+		curStartTime = now;
+
+		// the old process is still marked Running if it is about to go back on its run queue
+		TRACE(TRACE_SWITCH, newProc->pid, (oldProc == NULL) ? 0 : oldProc->pid,
+			(oldProc == NULL) ? -1 : (oldProc->state == 1) ? 0 : oldProc->state);
+	}
+
+	if (oldProc == NULL) { // don't store old proc on first process
+		USLOSS_ContextSwitch(NULL, coldOf(curProc)->context);
+	}
+	else if (oldProc != newProc) {
+		if (oldProc->state == 1) { // set old to Runnable if it wasn't terminated or blocked
+			oldProc->state = 0;
+			enqueue(oldProc);
+		}
+		USLOSS_ContextSwitch(coldOf(oldProc)->context, coldOf(curProc)->context);
+		releaseDeadStack();
+	}
+}
+
+/*
+* void releaseDeadStack(void) - gives the stack of the process that last quit back to the pool,
+*	if it hasn't been already. Called by a process right after it is switched to, when nothing
+*	is running on that stack anymore. Must be called with interrupts disabled.
+*/
+void releaseDeadStack(void) {
+	if (deadStack != NULL) {
+		stackPoolRelease(deadStack);
+		deadStack = NULL;
+	}
+}
+
+/*
+* void enqueue(struct pcb *proc) - adds a process to the tail of the run queue for its effective
+*	priority.
+*	proc - the process to add
+*/
+void enqueue(struct pcb *proc) {
+	int priority = proc->effectivePriority;
+	proc->nextInQueue = NULL;
+	proc->prevInQueue = queueTail[priority];
+	if (queueTail[priority] == NULL) {
+		queueHead[priority] = proc;
+	}
+	else {
+		queueTail[priority]->nextInQueue = proc;
+	}
+	queueTail[priority] = proc;
+	readyLevels |= 1 << priority;
+}
+
+/*
+* void dequeue(struct pcb *proc) - removes a process from the run queue for its effective priority.
+*	proc - the process to remove, which must be on its run queue
+*/
+void dequeue(struct pcb *proc) {
+	int priority = proc->effectivePriority;
+	if (proc->prevInQueue == NULL) {
+		queueHead[priority] = proc->nextInQueue;
+	}
+	else {
+		proc->prevInQueue->nextInQueue = proc->nextInQueue;
+	}
+	if (proc->nextInQueue == NULL) {
+		queueTail[priority] = proc->prevInQueue;
+	}
+	else {
+		proc->nextInQueue->prevInQueue = proc->prevInQueue;
+	}
+	proc->nextInQueue = NULL;
+	proc->prevInQueue = NULL;
+
+	if (queueHead[priority] == NULL) {
+		readyLevels &= ~(1 << priority);
+	}
+}
 
 
@@ -8,10 +8,13 @@
 #include <usloss.h>
 
 /*
- * Maximum number of processes. 
+ * Maximum number of processes, unless phase1_init_ex() or setMaxProcs() is used.
+ * Can be changed at build time with -DMAXPROC=n.
  */
 
+#ifndef MAXPROC
 #define MAXPROC      50
+#endif
 
 /*
  * Maximum length of a process name
@@ -37,16 +40,92 @@
  */
 
 extern void phase1_init(void);
+extern void phase1_init_ex(int maxProcesses);
+extern int  setMaxProcs(int maxProcesses);
 extern int  spork(char *name, int(*func)(void *), void *arg,
                   int stacksize, int priority);
+extern int  sporkMany(char *name, int(*func)(void *), void **args, int n,
+                      int stacksize, int priority, int *pids);
 extern int  join(int *status);
 
 extern void quit_phase_1a(int status, int switchToPid) __attribute__((__noreturn__));
 extern void quit         (int status)                  __attribute__((__noreturn__));
 
+extern void zap(int pid);
+extern int  isZapped(void);
+
 extern int  getpid(void);
+extern int  getpriority(void);
+extern int  getstate(int pid);
+extern int  getparent(int pid);
 extern void dumpProcesses(void);
 
+/*
+ * One process, as copied out of the process table by getProcessSnapshot().
+ */
+
+struct procInfo {
+	int  pid;
+	int  ppid; // 0 for init
+	int  priority;
+	int  effectivePriority; // priority it is scheduled at, raised by priority inheritance
+	int  state; // 0 = Runnable, 1 = Running, 2 = Terminated, 3 = Blocked
+	int  status; // return status, if terminated
+	int  blockReason; // why the process is blocked, 0 if it isn't
+	char name[MAXNAME];
+};
+
+extern int  getProcessSnapshot(struct procInfo *buf, int max);
+extern int  getChildCount(int pid);
+
+/*
+ * Block reasons up to 10 are reserved for phase 1; blockMe() must be
+ * passed a higher one.
+ */
+
+extern int  blockMe(int reason);
+extern int  unblockProc(int pid);
+
+/*
+ * Kernel entry and exit, for code built on phase 1 such as the phase 2
+ * mailboxes. enterKernel() halts if the CPU is not in kernel mode, disables
+ * interrupts and returns the previous PSR, which must be passed to
+ * leaveKernel() on the way out. Entries made this way are counted in
+ * getKernelStats() and are points where a recorded schedule can preempt.
+ */
+
+extern unsigned int enterKernel(char *func);
+extern void leaveKernel(unsigned int prevPsr);
+
+/*
+ * Counters kept by the kernel on its hot paths. They stay 0 if phase1 is
+ * compiled with -DNO_KERNEL_STATS.
+ */
+
+struct kernelStats {
+	long sporks; // successful spork() calls
+	long sporkFailFull; // spork() returned -1 because the table was full
+	long sporkFailStack; // spork() returned -2 because the stack was too small
+	long sporkFailInvalid; // spork() returned -1 because of a bad argument
+	long joins; // children joined
+	long quits; // processes that quit
+	long contextSwitches;
+	long slotProbes; // bitmap words looked at while finding free slots
+	int  maxSlotProbe; // most bitmap words looked at by one spork()
+	int  peakProcs; // most processes that existed at once
+	long psrCalls; // USLOSS_PsrGet() and USLOSS_PsrSet() calls made by the kernel
+};
+
+extern struct kernelStats getKernelStats(void);
+extern void dumpStats(void);
+
+extern int  setTimeSlice(int ms);
+extern int  setReparentOrphans(int on);
+extern int  setPriorityInheritance(int on);
+extern int  readtime(void);
+extern int  readCurStartTime(void);
+extern void dumpCpuTimes(void);
+
 void TEMP_switchTo(int pid);
 
 
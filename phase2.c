@@ -0,0 +1,456 @@
+/*
+ * Authors: Colton Patch, Ping Tontrasathien
+ * phase2.c - Implements mailboxes on top of the phase1 kernel. Messages are kept in slots taken
+ * 	from one preallocated pool, on a FIFO list in each mailbox, so sending and receiving never 
+ * 	allocate memory. A message sent to a mailbox that has a receiver waiting is copied straight
+ * 	into the receiver's buffer without using a slot. Processes that have to wait are queued on
+ * 	the mailbox in FIFO order, using a record on their own stack, and block with blockMe(); the
+ * 	process that satisfies them wakes them with unblockProc().
+ */
+
+#include <phase2.h>
+#include <string.h>
+
+//
+// structure for a message slot. Free slots are linked into the pool; used ones into their
+// mailbox's list of messages
+//
+struct slot {
+	struct slot *next;
+	int size;
+	char data[MAX_MESSAGE];
+};
+
+//
+// structure for a process waiting in a mailbox. It lives on the waiting process' stack, which
+// stays put while the process is blocked, so queueing it takes no allocation
+//
+struct waiter {
+	struct waiter *next;
+	int pid;
+	char *buf; // message to send, or buffer to receive into
+	int size; // size of the message, or of the buffer
+	int result; // what the blocked call returns, filled in by whoever wakes it
+	int done; // set by whoever wakes it, once it has been taken off the mailbox's lists
+};
+
+//
+// structure for a mailbox
+//
+struct mailbox {
+	int inUse;
+	int numSlots; // most messages it holds at once
+	int slotSize; // largest message it takes
+	int numMessages;
+	struct slot *firstMessage; // messages, oldest first
+	struct slot *lastMessage;
+	struct waiter *firstSender; // processes waiting to send, in the order they arrived
+	struct waiter *lastSender;
+	struct waiter *firstReceiver; // processes waiting to receive, in the order they arrived
+	struct waiter *lastReceiver;
+	int nextFree; // next unused mailbox id, while this one is unused
+};
+
+//
+// prototypes
+//
+struct mailbox *getMbox(int mbox_id);
+int sendMessage(char *func, int mbox_id, void *msg_ptr, int msg_size, int conditional);
+int recvMessage(char *func, int mbox_id, void *msg_ptr, int msg_max_size, int conditional);
+void putSlot(struct mailbox *mbox, void *msg_ptr, int msg_size);
+int copyMessage(void *dest, int maxSize, void *src, int size);
+void wakeWaiter(struct waiter *w, int result);
+
+//
+// global variables
+//
+int mboxInitialized = 0;
+struct mailbox mailboxes[MAXMBOX];
+int freeMbox = -1; // first unused mailbox id, -1 if none
+struct slot slots[MAXSLOTS];
+struct slot *freeSlotPool = NULL; // unused slots, linked by next
+struct mboxStats mboxStats;
+
+//
+// functions
+//
+
+/*
+* void phase2_init(void) - puts every mailbox id and every slot on its free list. Called by the 
+*	first MboxCreate() if nobody has called it before.
+*/
+void phase2_init(void) {
+	unsigned int prevPsr = enterKernel("phase2_init");
+
+	for (int i = 0; i < MAXMBOX; i++) {
+		mailboxes[i].inUse = 0;
+		mailboxes[i].nextFree = (i + 1 < MAXMBOX) ? i + 1 : -1;
+	}
+	freeMbox = 0;
+	for (int i = 0; i < MAXSLOTS; i++) {
+		slots[i].next = (i + 1 < MAXSLOTS) ? &slots[i + 1] : NULL;
+	}
+	freeSlotPool = &slots[0];
+	mboxStats.freeSlots = MAXSLOTS;
+	mboxInitialized = 1;
+
+	leaveKernel(prevPsr);
+}
+
+/*
+* int MboxCreate(int numSlots, int slotSize) - creates a mailbox and returns its id, or -1 if the
+*	arguments are out of range or every mailbox is in use. Slots come from the shared pool as 
+*	messages are sent, so creating a mailbox reserves none.
+*	numSlots - most messages the mailbox holds at once; 0 makes every send wait for a receiver
+*	slotSize - largest message the mailbox takes, in bytes
+*/
+int MboxCreate(int numSlots, int slotSize) {
+	if (!mboxInitialized) {
+		phase2_init();
+	}
+	unsigned int prevPsr = enterKernel("MboxCreate");
+
+	if (numSlots < 0 || numSlots > MAXSLOTS || slotSize < 0 || slotSize > MAX_MESSAGE || freeMbox == -1) {
+		leaveKernel(prevPsr);
+		return -1;
+	}
+
+	int id = freeMbox;
+	struct mailbox *mbox = &mailboxes[id];
+	freeMbox = mbox->nextFree;
+	mbox->inUse = 1;
+	mbox->numSlots = numSlots;
+	mbox->slotSize = slotSize;
+	mbox->numMessages = 0;
+	mbox->firstMessage = NULL;
+	mbox->lastMessage = NULL;
+	mbox->firstSender = NULL;
+	mbox->lastSender = NULL;
+	mbox->firstReceiver = NULL;
+	mbox->lastReceiver = NULL;
+
+	leaveKernel(prevPsr);
+	return id;
+}
+
+/*
+* int MboxRelease(int mbox_id) - destroys a mailbox, throwing away its messages. Every process 
+*	waiting in it is woken, and its MboxSend() or MboxRecv() returns -1. Returns -1 if the 
+*	mailbox doesn't exist, 0 otherwise.
+*	mbox_id - id of the mailbox
+*/
+int MboxRelease(int mbox_id) {
+	unsigned int prevPsr = enterKernel("MboxRelease");
+
+	struct mailbox *mbox = getMbox(mbox_id);
+	if (mbox == NULL) {
+		leaveKernel(prevPsr);
+		return -1;
+	}
+
+	// give the slots back to the pool
+	while (mbox->firstMessage != NULL) {
+		struct slot *s = mbox->firstMessage;
+		mbox->firstMessage = s->next;
+		s->next = freeSlotPool;
+		freeSlotPool = s;
+		mboxStats.freeSlots++;
+	}
+
+	// take the waiters off before freeing the id, since a woken process may run right away
+	struct waiter *senders = mbox->firstSender;
+	struct waiter *receivers = mbox->firstReceiver;
+	mbox->inUse = 0;
+	mbox->nextFree = freeMbox;
+	freeMbox = mbox_id;
+
+	struct waiter *lists[2] = {senders, receivers};
+	for (int i = 0; i < 2; i++) {
+		struct waiter *w = lists[i];
+		while (w != NULL) {
+			struct waiter *next = w->next; // w is gone once its process runs
+			wakeWaiter(w, -1);
+			w = next;
+		}
+	}
+
+	leaveKernel(prevPsr);
+	return 0;
+}
+
+/*
+* int MboxSend(int mbox_id, void *msg_ptr, int msg_size) - sends a message, waiting if the mailbox
+*	is full. Returns 0 once the message is sent, -1 if the mailbox doesn't exist, the message is
+*	too big or the mailbox was released while waiting, and -2 if the shared slot pool is empty.
+*	mbox_id - id of the mailbox
+*	msg_ptr - the message
+*	msg_size - size of the message in bytes
+*/
+int MboxSend(int mbox_id, void *msg_ptr, int msg_size) {
+	return sendMessage("MboxSend", mbox_id, msg_ptr, msg_size, 0);
+}
+
+/*
+* int MboxCondSend(int mbox_id, void *msg_ptr, int msg_size) - sends a message if that can be done
+*	without waiting. Returns 0 if the message was sent, -1 if the mailbox doesn't exist or the 
+*	message is too big, and -2 if the mailbox is full or the shared slot pool is empty.
+*	mbox_id - id of the mailbox
+*	msg_ptr - the message
+*	msg_size - size of the message in bytes
+*/
+int MboxCondSend(int mbox_id, void *msg_ptr, int msg_size) {
+	return sendMessage("MboxCondSend", mbox_id, msg_ptr, msg_size, 1);
+}
+
+/*
+* int MboxRecv(int mbox_id, void *msg_ptr, int msg_max_size) - receives the oldest message, 
+*	waiting for one if the mailbox is empty. Returns the size of the message, or -1 if the 
+*	mailbox doesn't exist, the message doesn't fit in the buffer or the mailbox was released 
+*	while waiting.
+*	mbox_id - id of the mailbox
+*	msg_ptr - buffer to receive the message into
+*	msg_max_size - size of the buffer in bytes
+*/
+int MboxRecv(int mbox_id, void *msg_ptr, int msg_max_size) {
+	return recvMessage("MboxRecv", mbox_id, msg_ptr, msg_max_size, 0);
+}
+
+/*
+* int MboxCondRecv(int mbox_id, void *msg_ptr, int msg_max_size) - receives the oldest message if
+*	there is one. Returns the size of the message, -1 if the mailbox doesn't exist or the 
+*	message doesn't fit in the buffer, and -2 if there is no message.
+*	mbox_id - id of the mailbox
+*	msg_ptr - buffer to receive the message into
+*	msg_max_size - size of the buffer in bytes
+*/
+int MboxCondRecv(int mbox_id, void *msg_ptr, int msg_max_size) {
+	return recvMessage("MboxCondRecv", mbox_id, msg_ptr, msg_max_size, 1);
+}
+
+/*
+* void getMboxStats(struct mboxStats *stats) - copies the mailbox counters into stats.
+*	stats - where to store the counters
+*/
+void getMboxStats(struct mboxStats *stats) {
+	unsigned int prevPsr = enterKernel("getMboxStats");
+	*stats = mboxStats;
+	leaveKernel(prevPsr);
+}
+
+/*
+* int sendMessage(char *func, int mbox_id, void *msg_ptr, int msg_size, int conditional) - does the work 
+*	of MboxSend() and MboxCondSend(). A waiting receiver gets the message copied straight into 
+*	its buffer; otherwise it goes in a slot, or the sender waits for room behind any senders 
+*	that are already waiting.
+*	func - name of the function called, for error messages
+*	mbox_id - id of the mailbox
+*	msg_ptr - the message
+*	msg_size - size of the message in bytes
+*	conditional - 1 to return -2 instead of waiting
+*/
+int sendMessage(char *func, int mbox_id, void *msg_ptr, int msg_size, int conditional) {
+	unsigned int prevPsr = enterKernel(func);
+
+	struct mailbox *mbox = getMbox(mbox_id);
+	if (mbox == NULL || msg_size < 0 || msg_size > mbox->slotSize || (msg_ptr == NULL && msg_size > 0)) {
+		leaveKernel(prevPsr);
+		return -1;
+	}
+
+	// hand the message straight to the receiver that has waited longest
+	if (mbox->firstReceiver != NULL) {
+		struct waiter *w = mbox->firstReceiver;
+		mbox->firstReceiver = w->next;
+		if (mbox->firstReceiver == NULL) {
+			mbox->lastReceiver = NULL;
+		}
+		mboxStats.sends++;
+		mboxStats.handoffs++;
+		wakeWaiter(w, copyMessage(w->buf, w->size, msg_ptr, msg_size));
+		leaveKernel(prevPsr);
+		return 0;
+	}
+
+	// put it in a slot if there is room and nobody is ahead of us
+	if (mbox->numMessages < mbox->numSlots && mbox->firstSender == NULL) {
+		if (freeSlotPool == NULL) {
+			leaveKernel(prevPsr);
+			return -2;
+		}
+		putSlot(mbox, msg_ptr, msg_size);
+		mboxStats.sends++;
+		leaveKernel(prevPsr);
+		return 0;
+	}
+
+	if (conditional) {
+		leaveKernel(prevPsr);
+		return -2;
+	}
+
+	// wait until a receiver takes the message, or moves it into a slot
+	struct waiter w = {NULL, getpid(), msg_ptr, msg_size, 0, 0};
+	if (mbox->lastSender == NULL) {
+		mbox->firstSender = &w;
+	}
+	else {
+		mbox->lastSender->next = &w;
+	}
+	mbox->lastSender = &w;
+	while (!w.done) {
+		blockMe(MBOX_SEND_BLOCK);
+	}
+
+	leaveKernel(prevPsr);
+	return w.result;
+}
+
+/*
+* int recvMessage(char *func, int mbox_id, void *msg_ptr, int msg_max_size, int conditional) - does the 
+*	work of MboxRecv() and MboxCondRecv(). Takes the oldest message from a slot, then moves the 
+*	message of the sender that has waited longest into the freed slot. A mailbox with no slots 
+*	takes the message straight from a waiting sender. Otherwise the receiver waits.
+*	func - name of the function called, for error messages
+*	mbox_id - id of the mailbox
+*	msg_ptr - buffer to receive the message into
+*	msg_max_size - size of the buffer in bytes
+*	conditional - 1 to return -2 instead of waiting
+*/
+int recvMessage(char *func, int mbox_id, void *msg_ptr, int msg_max_size, int conditional) {
+	unsigned int prevPsr = enterKernel(func);
+
+	struct mailbox *mbox = getMbox(mbox_id);
+	if (mbox == NULL || msg_max_size < 0 || (msg_ptr == NULL && msg_max_size > 0)) {
+		leaveKernel(prevPsr);
+		return -1;
+	}
+
+	int result;
+	if (mbox->firstMessage != NULL) {
+		// take the oldest message and give its slot back
+		struct slot *s = mbox->firstMessage;
+		mbox->firstMessage = s->next;
+		if (mbox->firstMessage == NULL) {
+			mbox->lastMessage = NULL;
+		}
+		mbox->numMessages--;
+		result = copyMessage(msg_ptr, msg_max_size, s->data, s->size);
+		s->next = freeSlotPool;
+		freeSlotPool = s;
+		mboxStats.freeSlots++;
+
+		// make room for the sender that has waited longest
+		if (mbox->firstSender != NULL) {
+			struct waiter *w = mbox->firstSender;
+			mbox->firstSender = w->next;
+			if (mbox->firstSender == NULL) {
+				mbox->lastSender = NULL;
+			}
+			putSlot(mbox, w->buf, w->size);
+			mboxStats.sends++;
+			wakeWaiter(w, 0);
+		}
+	}
+	else if (mbox->firstSender != NULL) {
+		// no slots: take the message straight from the sender
+		struct waiter *w = mbox->firstSender;
+		mbox->firstSender = w->next;
+		if (mbox->firstSender == NULL) {
+			mbox->lastSender = NULL;
+		}
+		result = copyMessage(msg_ptr, msg_max_size, w->buf, w->size);
+		mboxStats.sends++;
+		mboxStats.handoffs++;
+		wakeWaiter(w, 0);
+	}
+	else if (conditional) {
+		result = -2;
+	}
+	else {
+		// wait for a sender to copy a message into our buffer
+		struct waiter w = {NULL, getpid(), msg_ptr, msg_max_size, 0, 0};
+		if (mbox->lastReceiver == NULL) {
+			mbox->firstReceiver = &w;
+		}
+		else {
+			mbox->lastReceiver->next = &w;
+		}
+		mbox->lastReceiver = &w;
+		while (!w.done) {
+			blockMe(MBOX_RECV_BLOCK);
+		}
+		result = w.result;
+	}
+
+	leaveKernel(prevPsr);
+	return result;
+}
+
+/*
+* void putSlot(struct mailbox *mbox, void *msg_ptr, int msg_size) - copies a message into a slot
+*	from the pool and adds it to the end of a mailbox's messages. The pool must not be empty.
+*	mbox - the mailbox
+*	msg_ptr - the message
+*	msg_size - size of the message in bytes
+*/
+void putSlot(struct mailbox *mbox, void *msg_ptr, int msg_size) {
+	struct slot *s = freeSlotPool;
+	freeSlotPool = s->next;
+	mboxStats.freeSlots--;
+	mboxStats.slotsUsed++;
+
+	s->next = NULL;
+	s->size = msg_size;
+	memcpy(s->data, msg_ptr, msg_size);
+	if (mbox->lastMessage == NULL) {
+		mbox->firstMessage = s;
+	}
+	else {
+		mbox->lastMessage->next = s;
+	}
+	mbox->lastMessage = s;
+	mbox->numMessages++;
+}
+
+/*
+* int copyMessage(void *dest, int maxSize, void *src, int size) - copies a message into a 
+*	receiver's buffer. Returns the size of the message, or -1 if it doesn't fit, in which case 
+*	nothing is copied.
+*	dest - the receiver's buffer
+*	maxSize - size of the buffer
+*	src - the message
+*	size - size of the message
+*/
+int copyMessage(void *dest, int maxSize, void *src, int size) {
+	if (size > maxSize) {
+		return -1;
+	}
+	memcpy(dest, src, size);
+	return size;
+}
+
+/*
+* void wakeWaiter(struct waiter *w, int result) - gives a waiting process what its call returns
+*	and unblocks it. The waiter must already be off its mailbox's lists. Only this sets done, so
+*	a process that is resumed any other way goes back to waiting, and its waiter never leaves 
+*	the lists while it is still on its stack.
+*	w - the waiter, which is invalid once this returns
+*	result - what the waiting MboxSend() or MboxRecv() returns
+*/
+void wakeWaiter(struct waiter *w, int result) {
+	w->result = result;
+	w->done = 1;
+	unblockProc(w->pid);
+}
+
+/*
+* struct mailbox *getMbox(int mbox_id) - returns the mailbox with the given id, or NULL if there
+*	is none.
+*	mbox_id - id of the mailbox
+*/
+struct mailbox *getMbox(int mbox_id) {
+	if (mbox_id < 0 || mbox_id >= MAXMBOX || !mailboxes[mbox_id].inUse) {
+		return NULL;
+	}
+	return &mailboxes[mbox_id];
+}
@@ -0,0 +1,62 @@
+/*
+ * These are the definitions for phase2 of the project (mailboxes), built on
+ * the phase1 kernel.
+ */
+
+#ifndef _PHASE2_H
+#define _PHASE2_H
+
+#include <phase1.h>
+
+/*
+ * Maximum number of mailboxes that can exist at once
+ */
+
+#define MAXMBOX      2000
+
+/*
+ * Number of message slots shared by all mailboxes
+ */
+
+#define MAXSLOTS     2500
+
+/*
+ * Maximum size of a message, in bytes
+ */
+
+#define MAX_MESSAGE  150
+
+/*
+ * Block reasons used by the mailboxes, passed to blockMe()
+ */
+
+#define MBOX_SEND_BLOCK 11 // waiting in MboxSend() for a slot or a receiver
+#define MBOX_RECV_BLOCK 12 // waiting in MboxRecv() for a message
+
+/*
+ * These functions are provided by Phase 2.
+ */
+
+extern void phase2_init(void);
+
+extern int  MboxCreate    (int numSlots, int slotSize);
+extern int  MboxRelease   (int mbox_id);
+extern int  MboxSend      (int mbox_id, void *msg_ptr, int msg_size);
+extern int  MboxRecv      (int mbox_id, void *msg_ptr, int msg_max_size);
+extern int  MboxCondSend  (int mbox_id, void *msg_ptr, int msg_size);
+extern int  MboxCondRecv  (int mbox_id, void *msg_ptr, int msg_max_size);
+
+/*
+ * Counters kept by the mailboxes
+ */
+
+struct mboxStats {
+	long sends; // messages sent
+	long handoffs; // messages copied straight into a waiting receiver's buffer, without a slot
+	long slotsUsed; // messages that went through a slot
+	int  freeSlots; // slots currently unused
+};
+
+extern void getMboxStats(struct mboxStats *stats);
+
+#endif /* _PHASE2_H */
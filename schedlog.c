@@ -0,0 +1,173 @@
+/*
+ * Authors: Colton Patch, Ping Tontrasathien
+ * schedlog.c - Keeps the log of scheduling decisions for record mode, and hands them back to the
+ * 	dispatcher one at a time in replay mode. Functions called by the kernel must be called with
+ * 	interrupts disabled.
+ */
+
+#include <schedlog.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//
+// prototypes
+//
+void schedLogSaveAtExit(void);
+
+//
+// global variables
+//
+int schedLogMode = SCHED_LOG_OFF;
+struct schedDecision *schedLog = NULL; // decisions recorded, or loaded to replay
+int schedLogLength = 0; // number of decisions in schedLog
+int schedLogCapacity = 0; // room in schedLog
+int schedLogPos = 0; // index of the next decision to replay
+
+//
+// functions
+//
+
+/*
+* void schedLogInit(void) - starts recording or replaying if the PHASE1_RECORD or PHASE1_REPLAY
+*	environment variable is set. Called by phase1_init(). Halts if the replay log can't be read.
+*/
+void schedLogInit(void) {
+	char *recordPath = getenv("PHASE1_RECORD");
+	char *replayPath = getenv("PHASE1_REPLAY");
+
+	if (replayPath != NULL && *replayPath != '\0') {
+		if (schedLogStartReplay(replayPath) == -1) {
+			fprintf(stderr, "ERROR: Could not read the schedule to replay from %s\n", replayPath);
+			exit(1);
+		}
+	}
+	else if (recordPath != NULL && *recordPath != '\0') {
+		schedLogStartRecording();
+		atexit(&schedLogSaveAtExit);
+	}
+}
+
+/*
+* int schedLogStartRecording(void) - throws away any decisions in the log and starts recording.
+*	Returns 0.
+*/
+int schedLogStartRecording(void) {
+	schedLogLength = 0;
+	schedLogPos = 0;
+	schedLogMode = SCHED_LOG_RECORD;
+	return 0;
+}
+
+/*
+* int schedLogStartReplay(char *path) - loads a log written by schedLogSave() and starts replaying
+*	it. Returns the number of decisions loaded, or -1 if the file couldn't be read, in which case
+*	the mode is unchanged.
+*	path - name of the log file
+*/
+int schedLogStartReplay(char *path) {
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) {
+		return -1;
+	}
+	struct schedLogHeader header;
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != SCHED_LOG_MAGIC || header.numDecisions < 0) {
+		fclose(f);
+		return -1;
+	}
+	struct schedDecision *decisions = malloc((header.numDecisions + 1) * sizeof(struct schedDecision));
+	if (decisions == NULL || fread(decisions, sizeof(struct schedDecision), header.numDecisions, f) != header.numDecisions) {
+		free(decisions);
+		fclose(f);
+		return -1;
+	}
+	fclose(f);
+
+	free(schedLog);
+	schedLog = decisions;
+	schedLogLength = header.numDecisions;
+	schedLogCapacity = header.numDecisions + 1;
+	schedLogPos = 0;
+	schedLogMode = SCHED_LOG_REPLAY;
+	return schedLogLength;
+}
+
+/*
+* int schedLogSave(char *path) - writes the recorded decisions to a file. Returns the number 
+*	written, or -1 if the file couldn't be written.
+*	path - name of the log file
+*/
+int schedLogSave(char *path) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL) {
+		return -1;
+	}
+	struct schedLogHeader header = {SCHED_LOG_MAGIC, schedLogLength};
+	int ok = fwrite(&header, sizeof(header), 1, f) == 1 && 
+		fwrite(schedLog, sizeof(struct schedDecision), schedLogLength, f) == schedLogLength;
+	if (fclose(f) != 0 || !ok) {
+		return -1;
+	}
+	return schedLogLength;
+}
+
+/*
+* void schedLogSaveAtExit(void) - writes the recorded decisions to the file named by PHASE1_RECORD.
+*	Registered with atexit() so it runs when USLOSS_Halt() exits.
+*/
+void schedLogSaveAtExit(void) {
+	char *path = getenv("PHASE1_RECORD");
+	if (schedLogSave(path) == -1) {
+		fprintf(stderr, "ERROR: Could not write the schedule to %s\n", path);
+	}
+}
+
+/*
+* void schedLogRecord(int reason, int pid, int time, int elapsed, int points) - appends a decision
+*	to the log, doubling its size when it is full. Recording stops if there is no memory for it.
+*	reason - why the decision was made
+*	pid - process chosen to run
+*	time - clock time of the decision
+*	elapsed - how long the running process had been running
+*	points - kernel entries the running process had made with interrupts enabled since it was
+*		switched to
+*/
+void schedLogRecord(int reason, int pid, int time, int elapsed, int points) {
+	if (schedLogLength == schedLogCapacity) {
+		int newCapacity = (schedLogCapacity == 0) ? 1024 : schedLogCapacity * 2;
+		struct schedDecision *newLog = realloc(schedLog, newCapacity * sizeof(struct schedDecision));
+		if (newLog == NULL) {
+			schedLogMode = SCHED_LOG_OFF;
+			return;
+		}
+		schedLog = newLog;
+		schedLogCapacity = newCapacity;
+	}
+	struct schedDecision *d = &schedLog[schedLogLength++];
+	d->time = time;
+	d->pid = pid;
+	d->reason = reason;
+	d->elapsed = elapsed;
+	d->points = points;
+}
+
+/*
+* struct schedDecision *schedLogPeek(void) - returns the next decision to replay, or NULL if the
+*	log has run out, in which case replay is over and scheduling goes back to live.
+*/
+struct schedDecision *schedLogPeek(void) {
+	if (schedLogPos >= schedLogLength) {
+		schedLogMode = SCHED_LOG_OFF;
+		return NULL;
+	}
+	return &schedLog[schedLogPos];
+}
+
+/*
+* void schedLogNext(void) - moves on to the next decision to replay. Replay is over after the last one.
+*/
+void schedLogNext(void) {
+	schedLogPos++;
+	if (schedLogPos >= schedLogLength) {
+		schedLogMode = SCHED_LOG_OFF;
+	}
+}
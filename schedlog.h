@@ -0,0 +1,72 @@
+/*
+ * Definitions for recording and replaying the kernel's scheduling decisions.
+ * In record mode every decision the dispatcher makes, every preemption by
+ * the clock and every TEMP_switchTo() is appended to a log. In replay mode
+ * the dispatcher takes its decisions from a log instead, so a run with a bad
+ * interleaving can be repeated exactly, until the log runs out and the
+ * kernel goes back to scheduling live. A preemption is replayed at the
+ * kernel entry the preempted process was about to make, counted since it
+ * was last switched to, so a process that does the same thing each run is
+ * preempted at the same place. One whose path depends on the time it
+ * reads, such as one that spins until readtime() reaches a limit, can
+ * still diverge; replay halts when it does.
+ *
+ * Recording starts when phase 1 is initialized if the PHASE1_RECORD
+ * environment variable names a file, which the log is written to when the
+ * simulation exits; replay starts then if PHASE1_REPLAY names a log file.
+ * Both can also be started from a testcase.
+ */
+
+#ifndef _SCHEDLOG_H
+#define _SCHEDLOG_H
+
+/*
+ * Modes
+ */
+
+#define SCHED_LOG_OFF    0
+#define SCHED_LOG_RECORD 1
+#define SCHED_LOG_REPLAY 2
+
+/*
+ * Why a decision was made
+ */
+
+#define SCHED_DISPATCH 1 // the dispatcher was called by a kernel function
+#define SCHED_PREEMPT  2 // the clock handler found the time slice used up
+#define SCHED_SWITCH   3 // TEMP_switchTo() was called
+
+/*
+ * One decision
+ */
+
+struct schedDecision {
+	int time; // clock time in microseconds
+	int pid; // process chosen to run; the running process if it kept the CPU
+	int reason;
+	int elapsed; // microseconds the running process had been running for
+	int points; // kernel entries the running process had made with interrupts enabled since it was switched to
+};
+
+/*
+ * Header at the start of a log file, followed by numDecisions decisions
+ */
+
+#define SCHED_LOG_MAGIC 0x474c4453 // "SDLG"
+
+struct schedLogHeader {
+	int magic;
+	int numDecisions;
+};
+
+extern int schedLogMode;
+
+extern void schedLogInit(void);
+extern int  schedLogStartRecording(void);
+extern int  schedLogStartReplay(char *path);
+extern int  schedLogSave(char *path);
+extern void schedLogRecord(int reason, int pid, int time, int elapsed, int points);
+extern struct schedDecision *schedLogPeek(void);
+extern void schedLogNext(void);
+
+#endif /* _SCHEDLOG_H */
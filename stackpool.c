@@ -0,0 +1,175 @@
+/*
+ * Authors: Colton Patch, Ping Tontrasathien
+ * stackpool.c - Keeps free lists of process stacks (with their contexts) in size classes so
+ * 	they can be recycled between processes instead of being malloc'd by every spork().
+ * 	All functions must be called with interrupts disabled.
+ * 	By default stacks come from the heap. Built with -DSTACK_POOL_MMAP (make STACK_BACKEND=mmap),
+ * 	each stack is its own mapping instead, with an inaccessible guard page below it: the OS only
+ * 	commits the pages a process actually touches, and a stack overflow faults on the guard page
+ * 	instead of overwriting whatever is next to the stack.
+ */
+
+#include <stackpool.h>
+#include <stdlib.h>
+#ifdef STACK_POOL_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+//
+// prototypes
+//
+struct stackBlock *allocBlock(int size);
+void freeBlock(struct stackBlock *block);
+
+//
+// global variables
+//
+struct stackBlock *freeStacks[STACK_POOL_CLASSES]; // free list for each size class
+int numFreeStacks[STACK_POOL_CLASSES]; // length of each free list
+struct stackPoolStats poolStats;
+
+//
+// functions
+//
+
+/*
+* struct stackBlock *stackPoolGet(int stackSize) - returns a block with a stack of at least
+*	stackSize bytes, taken from the free list of its size class if possible. Returns NULL if
+*	the heap is out of memory.
+*	stackSize - the minimum size of the stack
+*/
+struct stackBlock *stackPoolGet(int stackSize) {
+	// find the size class
+	int sizeClass = 0;
+	while (sizeClass < STACK_POOL_CLASSES && (USLOSS_MIN_STACK << sizeClass) < stackSize) {
+		sizeClass++;
+	}
+
+	struct stackBlock *block;
+	if (sizeClass < STACK_POOL_CLASSES && freeStacks[sizeClass] != NULL) {
+		// reuse a free block
+		block = freeStacks[sizeClass];
+		freeStacks[sizeClass] = block->next;
+		numFreeStacks[sizeClass]--;
+		poolStats.cached--;
+		poolStats.reuses++;
+	}
+	else {
+		int size = (sizeClass < STACK_POOL_CLASSES) ? USLOSS_MIN_STACK << sizeClass : stackSize;
+		block = allocBlock(size);
+		if (block == NULL) {
+			return NULL;
+		}
+		block->sizeClass = (sizeClass < STACK_POOL_CLASSES) ? sizeClass : -1;
+		poolStats.mallocs++;
+	}
+	block->next = NULL;
+
+	poolStats.inUse++;
+	if (poolStats.inUse > poolStats.peakInUse) {
+		poolStats.peakInUse = poolStats.inUse;
+	}
+	return block;
+}
+
+/*
+* void stackPoolRelease(struct stackBlock *block) - gives a block back to the pool. It is kept
+*	on its class' free list unless that list is already full or the block has no class.
+*	block - the block to release, which must no longer be running
+*/
+void stackPoolRelease(struct stackBlock *block) {
+	poolStats.inUse--;
+
+	int sizeClass = block->sizeClass;
+	if (sizeClass == -1 || numFreeStacks[sizeClass] >= STACK_POOL_MAX_CACHED) {
+		freeBlock(block);
+		poolStats.frees++;
+		return;
+	}
+
+	block->next = freeStacks[sizeClass];
+	freeStacks[sizeClass] = block;
+	numFreeStacks[sizeClass]++;
+	poolStats.cached++;
+}
+
+/*
+* void stackPoolGetStats(struct stackPoolStats *stats) - copies the pool's counters into stats.
+*	stats - where to store the counters
+*/
+void stackPoolGetStats(struct stackPoolStats *stats) {
+	*stats = poolStats;
+}
+
+#ifndef STACK_POOL_MMAP
+
+/*
+* struct stackBlock *allocBlock(int size) - allocates a block and its stack from the heap, 
+*	together, with the stack 16-byte aligned after the header. Returns NULL if out of memory.
+*	size - size of the stack
+*/
+struct stackBlock *allocBlock(int size) {
+	int headerSize = (sizeof(struct stackBlock) + 15) & ~15;
+	struct stackBlock *block = malloc(headerSize + size);
+	if (block == NULL) {
+		return NULL;
+	}
+	block->size = size;
+	block->stack = (char *)block + headerSize;
+	return block;
+}
+
+/*
+* void freeBlock(struct stackBlock *block) - gives a block and its stack back to the heap.
+*	block - the block to free
+*/
+void freeBlock(struct stackBlock *block) {
+	free(block);
+}
+
+#else
+
+/*
+* struct stackBlock *allocBlock(int size) - allocates a block header from the heap and maps its 
+*	stack, rounded up to whole pages, with one more page below it that can't be accessed. The 
+*	stack's pages use no memory until they are touched. Returns NULL if out of memory.
+*	size - size of the stack
+*/
+struct stackBlock *allocBlock(int size) {
+	long pageSize = sysconf(_SC_PAGESIZE);
+	long mapSize = pageSize + (size + pageSize - 1) / pageSize * pageSize;
+
+	struct stackBlock *block = malloc(sizeof(struct stackBlock));
+	if (block == NULL) {
+		return NULL;
+	}
+	char *map = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (map == MAP_FAILED) {
+		free(block);
+		return NULL;
+	}
+
+	// the stack grows down, so the guard page goes at the lowest address
+	if (mprotect(map, pageSize, PROT_NONE) == -1) {
+		munmap(map, mapSize);
+		free(block);
+		return NULL;
+	}
+	block->size = mapSize - pageSize;
+	block->stack = map + pageSize;
+	return block;
+}
+
+/*
+* void freeBlock(struct stackBlock *block) - unmaps a block's stack and guard page, and gives the
+*	header back to the heap.
+*	block - the block to free
+*/
+void freeBlock(struct stackBlock *block) {
+	long pageSize = sysconf(_SC_PAGESIZE);
+	munmap(block->stack - pageSize, block->size + pageSize);
+	free(block);
+}
+
+#endif
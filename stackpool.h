@@ -0,0 +1,56 @@
+/*
+ * Definitions for the kernel's pool of process stacks and contexts. Stacks are
+ * handed out in size classes (USLOSS_MIN_STACK and power-of-two multiples of it)
+ * and kept on a free list when a process is joined, so that a steady stream of
+ * spork()/join() does no heap allocation.
+ */
+
+#ifndef _STACKPOOL_H
+#define _STACKPOOL_H
+
+#include <usloss.h>
+
+/*
+ * Number of size classes. Class i holds stacks of USLOSS_MIN_STACK << i bytes;
+ * anything larger is allocated exactly and freed when released.
+ */
+
+#define STACK_POOL_CLASSES    8
+
+/*
+ * Maximum number of free stacks kept in each class. Stacks released beyond this
+ * are given back to the heap.
+ */
+
+#define STACK_POOL_MAX_CACHED 50
+
+/*
+ * A stack and the context that runs on it
+ */
+
+struct stackBlock {
+	struct stackBlock *next; // next free block in the same class
+	int sizeClass; // -1 if too big for any class
+	int size; // usable size of stack
+	char *stack;
+	USLOSS_Context context;
+};
+
+/*
+ * Counters kept by the pool
+ */
+
+struct stackPoolStats {
+	int mallocs; // blocks allocated from the heap, or mapped
+	int frees; // blocks given back to the heap, or unmapped
+	int reuses; // blocks handed out from a free list
+	int inUse; // blocks currently held by processes
+	int peakInUse; // high-water mark of inUse
+	int cached; // blocks currently on the free lists
+};
+
+extern struct stackBlock *stackPoolGet(int stackSize);
+extern void stackPoolRelease(struct stackBlock *block);
+extern void stackPoolGetStats(struct stackPoolStats *stats);
+
+#endif /* _STACKPOOL_H */
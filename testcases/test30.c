@@ -0,0 +1,77 @@
+/*
+ * Raise the process limit with setMaxProcs(), then create 10000 children
+ * (without joining any of them), join them all, and check that the table
+ * still works normally afterwards.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define NUM_KIDS 10000
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status, prevPid;
+    int pids[3];
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: After raising the process limit, %d children can exist at once.  spork() fails once the new limit is reached, and every child can be joined.\n", NUM_KIDS);
+
+    /* init and testcase_main count against the limit */
+    if (setMaxProcs(1) != -1) {
+        USLOSS_Console("ERROR: setMaxProcs() accepted a limit below the number of processes\n");
+        USLOSS_Halt(1);
+    }
+    setMaxProcs(NUM_KIDS + 2);
+
+    for (i = 0; i < NUM_KIDS; i++) {
+        kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+        if (kidpid != i + 3) {
+            USLOSS_Console("ERROR: spork() number %d returned %d\n", i, kidpid);
+            USLOSS_Halt(1);
+        }
+        TEMP_switchTo(kidpid);
+    }
+    USLOSS_Console("testcase_main(): created %d children\n", NUM_KIDS);
+
+    kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+    USLOSS_Console("testcase_main(): spork() past the limit returned %d\n", kidpid);
+
+    prevPid = NUM_KIDS + 3;
+    for (i = 0; i < NUM_KIDS; i++) {
+        kidpid = join(&status);
+        if (kidpid != prevPid - 1 || status != kidpid) {
+            USLOSS_Console("ERROR: join() number %d returned %d, status %d\n", i, kidpid, status);
+            USLOSS_Halt(1);
+        }
+        prevPid = kidpid;
+    }
+    USLOSS_Console("testcase_main(): joined %d children\n", NUM_KIDS);
+    USLOSS_Console("testcase_main(): join() with no children returned %d\n", join(&status));
+
+    for (i = 0; i < 3; i++) {
+        pids[i] = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+        TEMP_switchTo(pids[i]);
+    }
+    USLOSS_Console("testcase_main(): sporked %d %d %d\n", pids[0], pids[1], pids[2]);
+    dumpProcesses();
+
+    for (i = 0; i < 3; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): joined child %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(getpid(), tm_pid);
+}
@@ -0,0 +1,42 @@
+/*
+ * Check that join() blocks when no child has died yet, and that the
+ * dispatcher then runs children in priority order, FIFO within a priority.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Four children are created but not switched to.  Each join() blocks, and the dispatcher runs the highest priority child; the two priority 2 children run in the order they were created.\n");
+
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("XXp1", XXp1, "prio 5", USLOSS_MIN_STACK, 5));
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("XXp1", XXp1, "prio 2, first", USLOSS_MIN_STACK, 2));
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("XXp1", XXp1, "prio 4", USLOSS_MIN_STACK, 4));
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("XXp1", XXp1, "prio 2, second", USLOSS_MIN_STACK, 2));
+    dumpProcesses();
+
+    for (i = 0; i < 4; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    USLOSS_Console("XXp1(): pid %d started, arg = '%s'\n", getpid(), arg);
+    dumpProcesses();
+    quit_phase_1a(getpid(), tm_pid);
+}
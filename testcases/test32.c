@@ -0,0 +1,62 @@
+/*
+ * Check quit(): children that call quit() wake their parent out of join(),
+ * the dispatcher picks who runs next, and a terminated child's stack goes
+ * back to the pool before it is joined.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <stackpool.h>
+
+int XXp1(void *), XXp2(void *);
+
+int tm_pid = -1;
+
+static int stacksInUse(void)
+{
+    struct stackPoolStats stats;
+    stackPoolGetStats(&stats);
+    return stats.inUse;
+}
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: XXp1 (priority 2) creates XXp2 (priority 1) and joins it, then quits.  A second XXp1 (priority 4) quits right away.  Each join() wakes up when the child quits, and the stacks in use drop as soon as a child has quit.\n");
+
+    spork("XXp1", XXp1, "first", USLOSS_MIN_STACK, 4);
+    spork("XXp1", XXp1, "second", USLOSS_MIN_STACK, 2);
+    USLOSS_Console("testcase_main(): stacks in use = %d\n", stacksInUse());
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d, stacks in use = %d\n", kidpid, status, stacksInUse());
+    }
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    int kidpid, status;
+
+    USLOSS_Console("XXp1(): pid %d started, arg = '%s'\n", getpid(), arg);
+    if (((char *)arg)[0] == 's') {
+        spork("XXp2", XXp2, NULL, USLOSS_MIN_STACK, 1);
+        kidpid = join(&status);
+        USLOSS_Console("XXp1(): join returned %d, status = %d\n", kidpid, status);
+        dumpProcesses();
+    }
+    quit(getpid() * 10);
+}
+
+int XXp2(void *arg)
+{
+    USLOSS_Console("XXp2(): pid %d started\n", getpid());
+    quit(getpid() * 10);
+}
@@ -0,0 +1,52 @@
+/*
+ * Check the kernel statistics: successful and failed sporks, joins, quits,
+ * context switches (in total and per process) and the peak process count.
+ * The PSR calls are only checked against a bound, since the exact count
+ * changes whenever a kernel path is tuned.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define MAX_PSR_CALLS 20 /* per child created, run and joined */
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+    long psrCalls;
+    struct kernelStats stats;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Three children are created and joined, one spork() fails because of the stack size and one because of the priority.  dumpStats() shows the counts.\n");
+
+    USLOSS_Console("testcase_main(): spork with small stack returned %d\n", spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK - 1, 2));
+    USLOSS_Console("testcase_main(): spork with bad priority returned %d\n", spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 7));
+
+    psrCalls = getKernelStats().psrCalls;
+    for (i = 0; i < 3; i++) {
+        kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+        TEMP_switchTo(kidpid);
+    }
+    for (i = 0; i < 3; i++)
+        join(&status);
+    psrCalls = getKernelStats().psrCalls - psrCalls;
+
+    stats = getKernelStats();
+    USLOSS_Console("testcase_main(): getKernelStats() says %ld sporks, %ld joins, peak %d processes\n", stats.sporks, stats.joins, stats.peakProcs);
+    USLOSS_Console("testcase_main(): at most %d PSR calls per child: %s\n", MAX_PSR_CALLS, (psrCalls > 0 && psrCalls <= 3 * MAX_PSR_CALLS) ? "yes" : "no");
+    dumpStats();
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(0, tm_pid);
+}
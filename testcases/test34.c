@@ -0,0 +1,44 @@
+/*
+ * Check CPU time accounting: a child that spins is charged for its time,
+ * and its parent, which is blocked in join() meanwhile, is not.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define SPIN_TIME 20000
+
+int XXp1(void *);
+extern int currentTime(void);
+
+int testcase_main()
+{
+    int status, before, after;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: XXp1 spins until readtime() says it has used %d usec.  testcase_main() is blocked in join() meanwhile, so its own readtime() grows by much less than that.\n", SPIN_TIME);
+
+    before = readtime();
+    spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+    join(&status);
+    after = readtime();
+
+    USLOSS_Console("testcase_main(): XXp1 used at least %d usec: %s\n", SPIN_TIME, (status >= SPIN_TIME) ? "yes" : "no");
+    USLOSS_Console("testcase_main(): own time grew by less than %d usec: %s\n", SPIN_TIME, (after - before < SPIN_TIME) ? "yes" : "no");
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    int start = readCurStartTime();
+
+    USLOSS_Console("XXp1(): started\n");
+    USLOSS_Console("XXp1(): start time is not in the future: %s\n", (start <= currentTime()) ? "yes" : "no");
+
+    while (readtime() < SPIN_TIME)
+        ;
+
+    quit(readtime());
+}
@@ -0,0 +1,65 @@
+/*
+ * Check time slicing: three CPU-bound processes at the same priority take
+ * turns on the CPU, in FIFO order.  How long they wait for their turns
+ * depends on the load on the machine, so it isn't checked here.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define TIME_SLICE 80 /* ms */
+#define SPIN_TIME  300000 /* usec of CPU each spinner uses */
+#define LOG_SIZE   9
+
+int Spinner(void *);
+
+int sliceLog[LOG_SIZE]; /* pids of the first few time slices, in order */
+int sliceCount = 0;
+
+int testcase_main()
+{
+    int i, status, moreThanOne = 0;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Three spinners at priority 4 share the CPU round-robin in %d ms time slices.  Each gets several turns.\n", TIME_SLICE);
+
+    setTimeSlice(TIME_SLICE);
+
+    for (i = 0; i < 3; i++)
+        spork("Spinner", Spinner, NULL, USLOSS_MIN_STACK, 4);
+
+    /* which one finishes first depends on the load on the machine */
+    for (i = 0; i < 3; i++) {
+        join(&status);
+        moreThanOne += status;
+    }
+    USLOSS_Console("testcase_main(): joined 3 spinners, all of which had more than one turn: %s\n", (moreThanOne == 3) ? "yes" : "no");
+
+    USLOSS_Console("testcase_main(): first %d time slices went to:", LOG_SIZE);
+    for (i = 0; i < LOG_SIZE; i++)
+        USLOSS_Console(" %d", sliceLog[i]);
+    USLOSS_Console("\n");
+
+    return 0;
+}
+
+int Spinner(void *arg)
+{
+    int sliceStart = readCurStartTime();
+    int turns = 1;
+
+    sliceLog[sliceCount++] = getpid();
+
+    while (readtime() < SPIN_TIME) {
+        /* a new time slice started since we last looked */
+        if (readCurStartTime() != sliceStart) {
+            sliceStart = readCurStartTime();
+            if (sliceCount < LOG_SIZE)
+                sliceLog[sliceCount++] = getpid();
+            turns++;
+        }
+    }
+
+    quit(turns > 1);
+}
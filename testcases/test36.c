@@ -0,0 +1,57 @@
+/*
+ * Check blockMe() and unblockProc(): a blocked process is shown as
+ * Blocked(reason), is not run until it is unblocked, and runs right away
+ * when a lower priority process unblocks it.  unblockProc() refuses
+ * processes that are not blocked in blockMe().
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Blocker(void *);
+int Waker(void *);
+
+int tm_pid = -1;
+int blocker_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Blocker blocks itself with reason 20, so Waker runs next and sees it as Blocked(20).  Waker unblocks it, and Blocker runs before unblockProc() returns, since it has a higher priority.\n");
+
+    blocker_pid = spork("Blocker", Blocker, NULL, USLOSS_MIN_STACK, 4);
+    USLOSS_Console("testcase_main(): spork returned %d\n", blocker_pid);
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("Waker", Waker, NULL, USLOSS_MIN_STACK, 5));
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int Blocker(void *arg)
+{
+    USLOSS_Console("Blocker(): started, calling blockMe(20)\n");
+    USLOSS_Console("Blocker(): blockMe returned %d\n", blockMe(20));
+    USLOSS_Console("Blocker(): unblockProc on myself while running returned %d\n", unblockProc(getpid()));
+    quit_phase_1a(1, tm_pid);
+}
+
+int Waker(void *arg)
+{
+    USLOSS_Console("Waker(): started\n");
+    dumpProcesses();
+    USLOSS_Console("Waker(): unblockProc(%d)\n", blocker_pid);
+    USLOSS_Console("Waker(): unblockProc returned %d\n", unblockProc(blocker_pid));
+    USLOSS_Console("Waker(): unblockProc on testcase_main, which is blocked in join(), returned %d\n", unblockProc(tm_pid));
+    USLOSS_Console("Waker(): unblockProc on a pid that doesn't exist returned %d\n", unblockProc(blocker_pid + 100));
+    dumpProcesses();
+    quit_phase_1a(2, tm_pid);
+}
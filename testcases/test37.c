@@ -0,0 +1,56 @@
+/*
+ * Check zap() with many zappers: five processes zap the same target and
+ * block, the target sees that it has been zapped, and all five are woken
+ * when it quits.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define NUM_ZAPPERS 5
+
+int Target(void *);
+int Zapper(void *);
+
+int tm_pid = -1;
+int target_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: %d zappers block in zap() on Target, which then runs, sees isZapped() == 1 and quits.  Every zapper is woken and returns from zap().\n", NUM_ZAPPERS);
+
+    target_pid = spork("Target", Target, NULL, USLOSS_MIN_STACK, 5);
+    USLOSS_Console("testcase_main(): spork returned %d\n", target_pid);
+    for (i = 0; i < NUM_ZAPPERS; i++) {
+        USLOSS_Console("testcase_main(): spork returned %d\n", spork("Zapper", Zapper, NULL, USLOSS_MIN_STACK, 4));
+    }
+
+    for (i = 0; i < NUM_ZAPPERS + 1; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    USLOSS_Console("testcase_main(): isZapped returned %d\n", isZapped());
+    return 0;
+}
+
+int Target(void *arg)
+{
+    USLOSS_Console("Target(): started, isZapped returned %d\n", isZapped());
+    dumpProcesses();
+    quit_phase_1a(1, tm_pid);
+}
+
+int Zapper(void *arg)
+{
+    USLOSS_Console("Zapper(): pid %d zapping %d\n", getpid(), target_pid);
+    zap(target_pid);
+    USLOSS_Console("Zapper(): pid %d zap returned\n", getpid());
+    quit_phase_1a(getpid(), tm_pid);
+}
@@ -0,0 +1,18 @@
+/*
+ * Check that zap() on init halts the simulation.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int testcase_main()
+{
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: zap() on init reports an error and halts.\n");
+
+    zap(1);
+
+    USLOSS_Console("testcase_main(): zap returned, which should not happen\n");
+    return 0;
+}
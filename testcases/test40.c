@@ -0,0 +1,18 @@
+/*
+ * Check that zap() on a pid that doesn't exist halts the simulation.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int testcase_main()
+{
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: zap() on a non-existent process reports an error and halts.\n");
+
+    zap(1000);
+
+    USLOSS_Console("testcase_main(): zap returned, which should not happen\n");
+    return 0;
+}
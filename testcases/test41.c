@@ -0,0 +1,70 @@
+/*
+ * Check that a stale pid doesn't reach the process that reused its slot.
+ * A child is created and joined, then enough children are created and
+ * joined that a new process lands in the same slot.  unblockProc() on the
+ * old pid must fail, and on the new pid must succeed.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Child(void *);
+int Blocker(void *);
+int Waker(void *);
+
+int tm_pid = -1;
+int old_pid = -1;
+int new_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Blocker gets the slot of a joined child.  unblockProc() on the joined child's pid returns -2 and leaves Blocker blocked; on Blocker's own pid it returns 0.\n");
+
+    old_pid = spork("Child", Child, NULL, USLOSS_MIN_STACK, 4);
+    join(&status);
+
+    // churn through the rest of the slots up to slot 0; slots 1 and 2 hold init and
+    // testcase_main, so the next process goes in the old child's slot
+    do {
+        kidpid = spork("Child", Child, NULL, USLOSS_MIN_STACK, 4);
+        join(&status);
+    } while (kidpid % MAXPROC != 0);
+
+    new_pid = spork("Blocker", Blocker, NULL, USLOSS_MIN_STACK, 4);
+    USLOSS_Console("testcase_main(): old pid %d, new pid %d, same slot: %s\n", old_pid, new_pid, (old_pid % MAXPROC == new_pid % MAXPROC) ? "yes" : "no");
+    spork("Waker", Waker, NULL, USLOSS_MIN_STACK, 5);
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int Child(void *arg)
+{
+    quit_phase_1a(0, tm_pid);
+}
+
+int Blocker(void *arg)
+{
+    USLOSS_Console("Blocker(): pid %d calling blockMe(20)\n", getpid());
+    blockMe(20);
+    USLOSS_Console("Blocker(): unblocked\n");
+    quit_phase_1a(1, tm_pid);
+}
+
+int Waker(void *arg)
+{
+    USLOSS_Console("Waker(): unblockProc(%d) returned %d\n", old_pid, unblockProc(old_pid));
+    dumpProcesses();
+    USLOSS_Console("Waker(): unblockProc(%d) returned %d\n", new_pid, unblockProc(new_pid));
+    quit_phase_1a(2, tm_pid);
+}
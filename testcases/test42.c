@@ -0,0 +1,38 @@
+/*
+ * Check that TEMP_switchTo() on a pid that has been joined halts, rather
+ * than switching to whatever process is in its slot.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int status, kidpid;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: XXp1 is created, switched to and joined; then TEMP_switchTo() on its pid reports an error and halts.\n");
+
+    kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 4);
+    TEMP_switchTo(kidpid);
+    kidpid = join(&status);
+    USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+
+    TEMP_switchTo(kidpid);
+
+    USLOSS_Console("testcase_main(): TEMP_switchTo returned, which should not happen\n");
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    USLOSS_Console("XXp1(): started\n");
+    quit_phase_1a(3, tm_pid);
+}
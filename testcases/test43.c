@@ -0,0 +1,53 @@
+/*
+ * Check getProcessSnapshot(): it copies every process in the table, in the
+ * same order as dumpProcesses(), and never more than the buffer holds.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, count, kidpid, status;
+    struct procInfo procs[10];
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: The snapshot lists init, testcase_main and three children, one of them terminated with status 7.  A snapshot into a buffer of 2 stops after 2 processes.\n");
+
+    kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 2);
+    TEMP_switchTo(kidpid);
+    spork("XXp2", XXp1, NULL, USLOSS_MIN_STACK, 4);
+    spork("XXp3", XXp1, NULL, USLOSS_MIN_STACK, 5);
+
+    count = getProcessSnapshot(procs, 10);
+    USLOSS_Console("testcase_main(): getProcessSnapshot returned %d\n", count);
+    for (i = 0; i < count; i++) {
+        USLOSS_Console("testcase_main(): pid %d, ppid %d, name %s, priority %d, state %d", procs[i].pid, procs[i].ppid, procs[i].name, procs[i].priority, procs[i].state);
+        if (procs[i].state == 2)
+            USLOSS_Console(", status %d", procs[i].status);
+        USLOSS_Console("\n");
+    }
+    dumpProcesses();
+
+    count = getProcessSnapshot(procs, 2);
+    USLOSS_Console("testcase_main(): getProcessSnapshot with room for 2 returned %d, last pid %d\n", count, procs[count - 1].pid);
+
+    for (i = 0; i < 3; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(7, tm_pid);
+}
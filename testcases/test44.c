@@ -0,0 +1,70 @@
+/*
+ * Check that large stacks only use memory for the pages a process touches:
+ * 40 processes are created with 1MB stacks, each touches 16KB of its stack,
+ * and once they have all run, the simulator's resident set has grown by
+ * much less than 40MB.  The resident set size is read from /proc/self/statm,
+ * so this needs Linux.  test56 checks the guard pages of the mmap backend.
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define NUM_KIDS   40
+#define STACK_SIZE (1024 * 1024)
+#define RSS_LIMIT  (8 * 1024 * 1024) /* bytes */
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+static long residentBytes(void)
+{
+    long size, resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f == NULL)
+        return 0;
+    if (fscanf(f, "%ld %ld", &size, &resident) != 2)
+        resident = 0;
+    fclose(f);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+int testcase_main()
+{
+    int i, status;
+    long before, after;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: %d children with 1MB stacks are created, run and joined.  Afterwards the resident set has grown by less than %d bytes.\n", NUM_KIDS, RSS_LIMIT);
+
+    before = residentBytes();
+    for (i = 0; i < NUM_KIDS; i++) {
+        if (spork("XXp1", XXp1, NULL, STACK_SIZE, 4) < 0) {
+            USLOSS_Console("testcase_main(): spork failed\n");
+            USLOSS_Halt(1);
+        }
+    }
+
+    for (i = 0; i < NUM_KIDS; i++)
+        join(&status);
+    USLOSS_Console("testcase_main(): joined %d children\n", i);
+
+    after = residentBytes();
+    USLOSS_Console("testcase_main(): resident set grew by less than %d bytes: %s\n", RSS_LIMIT, (after - before < RSS_LIMIT) ? "yes" : "no");
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    char buf[16 * 1024]; /* touch a few pages of the stack */
+    int i;
+
+    for (i = 0; i < sizeof(buf); i += 1024)
+        buf[i] = i;
+    quit_phase_1a(buf[1024], tm_pid);
+}
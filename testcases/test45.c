@@ -0,0 +1,54 @@
+/*
+ * Check the child list when children quit out of order: the middle and
+ * oldest children quit first, getChildCount() drops as each one quits,
+ * and dumpProcesses() and join() still see every child.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+    int kids[4];
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Four children are created.  The second, then the first, then the fourth and third quit; the child count goes 4, 3, 2, 1, 0.  getChildCount() on a pid that doesn't exist returns -1.\n");
+
+    for (i = 0; i < 4; i++)
+        kids[i] = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 4);
+    USLOSS_Console("testcase_main(): getChildCount returned %d\n", getChildCount(tm_pid));
+
+    TEMP_switchTo(kids[1]);
+    USLOSS_Console("testcase_main(): getChildCount returned %d\n", getChildCount(tm_pid));
+    TEMP_switchTo(kids[0]);
+    USLOSS_Console("testcase_main(): getChildCount returned %d\n", getChildCount(tm_pid));
+    dumpProcesses();
+    TEMP_switchTo(kids[3]);
+    USLOSS_Console("testcase_main(): getChildCount returned %d\n", getChildCount(tm_pid));
+    TEMP_switchTo(kids[2]);
+    USLOSS_Console("testcase_main(): getChildCount returned %d\n", getChildCount(tm_pid));
+
+    for (i = 0; i < 4; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    USLOSS_Console("testcase_main(): getChildCount of init returned %d\n", getChildCount(1));
+    USLOSS_Console("testcase_main(): getChildCount of pid %d returned %d\n", kids[0], getChildCount(kids[0]));
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    USLOSS_Console("XXp1(): pid %d quitting\n", getpid());
+    quit_phase_1a(getpid(), tm_pid);
+}
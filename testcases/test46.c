@@ -0,0 +1,65 @@
+/*
+ * Check orphan reparenting: with setReparentOrphans(1), a process that
+ * quits with a terminated child and a live child doesn't halt the
+ * simulation.  Both children are given to init, which joins them once
+ * they have quit, freeing their slots.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Sup(void *);
+int Worker(void *);
+
+int tm_pid = -1;
+int sup_pid = -1;
+int w2_pid = -1;
+
+int testcase_main()
+{
+    int kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Sup creates two workers, the first of which quits, then Sup quits without joining either.  Both become children of init.  When the second quits, init joins them both.\n");
+
+    USLOSS_Console("testcase_main(): setReparentOrphans returned %d\n", setReparentOrphans(1));
+
+    sup_pid = spork("Sup", Sup, NULL, USLOSS_MIN_STACK, 4);
+    TEMP_switchTo(sup_pid);
+
+    kidpid = join(&status);
+    USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    USLOSS_Console("testcase_main(): init has %d live children\n", getChildCount(1));
+    dumpProcesses();
+
+    TEMP_switchTo(w2_pid);
+
+    USLOSS_Console("testcase_main(): init has %d live children\n", getChildCount(1));
+    dumpProcesses();
+
+    return 0;
+}
+
+int Sup(void *arg)
+{
+    int w1_pid;
+
+    w1_pid = spork("Worker1", Worker, NULL, USLOSS_MIN_STACK, 5);
+    w2_pid = spork("Worker2", Worker, NULL, USLOSS_MIN_STACK, 5);
+    TEMP_switchTo(w1_pid);
+
+    USLOSS_Console("Sup(): quitting with children\n");
+    dumpProcesses();
+    quit_phase_1a(3, tm_pid);
+}
+
+int Worker(void *arg)
+{
+    USLOSS_Console("Worker(): pid %d quitting\n", getpid());
+    if (getpid() == w2_pid)
+        return 2; /* quits and switches to its parent, now init */
+    quit_phase_1a(1, sup_pid);
+}
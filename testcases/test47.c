@@ -0,0 +1,67 @@
+/*
+ * Check priority inheritance: a priority 1 process joins its priority 5
+ * worker while an unrelated priority 3 hog is runnable.  With inheritance
+ * on, the worker runs at priority 1 and finishes before the hog, instead
+ * of waiting for the hog's whole run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define HOG_TIME 200000 /* usec of CPU the hog uses */
+
+int Parent(void *);
+int Worker(void *);
+int Hog(void *);
+
+int hogDone = 0;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Hog (priority 3) is runnable when Parent (priority 1) creates Worker (priority 5) and joins it.  Worker inherits priority 1, runs before Hog, and Parent joins it before Hog has finished.\n");
+
+    USLOSS_Console("testcase_main(): setPriorityInheritance returned %d\n", setPriorityInheritance(1));
+
+    USLOSS_Console("testcase_main(): spork returned %d\n", spork("Hog", Hog, NULL, USLOSS_MIN_STACK, 3));
+    kidpid = spork("Parent", Parent, NULL, USLOSS_MIN_STACK, 1);
+    TEMP_switchTo(kidpid);
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int Parent(void *arg)
+{
+    int kidpid, status;
+
+    USLOSS_Console("Parent(): spork returned %d\n", spork("Worker", Worker, NULL, USLOSS_MIN_STACK, 5));
+
+    kidpid = join(&status);
+    USLOSS_Console("Parent(): join returned %d, status = %d, Hog has finished: %s\n", kidpid, status, hogDone ? "yes" : "no");
+
+    quit(1);
+}
+
+int Worker(void *arg)
+{
+    USLOSS_Console("Worker(): running, Hog has finished: %s\n", hogDone ? "yes" : "no");
+    dumpProcesses();
+    quit(5);
+}
+
+int Hog(void *arg)
+{
+    USLOSS_Console("Hog(): running\n");
+    while (readtime() < HOG_TIME)
+        ;
+    hogDone = 1;
+    quit(3);
+}
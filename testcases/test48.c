@@ -0,0 +1,54 @@
+/*
+ * Check the scheduler trace: traceDump() writes the events recorded so far,
+ * oldest first, after a header.  The file is read back and the events are
+ * printed without their timestamps, which vary from run to run.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <trace.h>
+
+#define TRACE_FILE "test48.trace"
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int kidpid, status, count;
+    FILE *f;
+    struct traceHeader header;
+    struct traceEvent e;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: A child is created, switched to, quits and is joined.  The trace has every spork, switch, quit and join since init started, in order.\n");
+
+    kidpid = spork("XXp1", XXp1, NULL, USLOSS_MIN_STACK, 4);
+    TEMP_switchTo(kidpid);
+    join(&status);
+
+    count = traceDump(TRACE_FILE);
+    USLOSS_Console("testcase_main(): traceDump returned %d\n", count);
+
+    f = fopen(TRACE_FILE, "rb");
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1) {
+        USLOSS_Console("testcase_main(): could not read %s\n", TRACE_FILE);
+        USLOSS_Halt(1);
+    }
+    USLOSS_Console("testcase_main(): header magic ok: %s, %d events, %d dropped\n", (header.magic == TRACE_MAGIC) ? "yes" : "no", header.numEvents, header.dropped);
+    while (fread(&e, sizeof(e), 1, f) == 1)
+        USLOSS_Console("testcase_main(): type %d, pid %d, other pid %d, status %d\n", e.type, e.pid, e.otherPid, e.status);
+    fclose(f);
+    remove(TRACE_FILE);
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    quit_phase_1a(9, tm_pid);
+}
@@ -0,0 +1,82 @@
+/*
+ * Check recording and replaying the schedule.  Two children are created
+ * and joined while recording, and the recorded decisions are printed.
+ * Then a schedule that runs the younger of two new children first is
+ * written by hand and replayed; the dispatcher follows it even though it
+ * would normally run the older one first.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <schedlog.h>
+
+#define LOG_FILE "test49.log"
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+void runTwoChildren(char *name1, char *name2, int *pid1, int *pid2)
+{
+    int i, kidpid, status;
+
+    *pid1 = spork(name1, XXp1, name1, USLOSS_MIN_STACK, 4);
+    *pid2 = spork(name2, XXp1, name2, USLOSS_MIN_STACK, 4);
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d\n", kidpid);
+    }
+}
+
+int testcase_main()
+{
+    int i, count, pid1, pid2;
+    FILE *f;
+    struct schedLogHeader header;
+    struct schedDecision d[4];
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: While recording, A runs before B, and the log has a dispatch and a switch back for each.  When replaying a log that says D first, D runs before C.\n");
+
+    schedLogStartRecording();
+    runTwoChildren("A", "B", &pid1, &pid2);
+    count = schedLogSave(LOG_FILE);
+    USLOSS_Console("testcase_main(): schedLogSave returned %d\n", count);
+
+    f = fopen(LOG_FILE, "rb");
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1) {
+        USLOSS_Console("testcase_main(): could not read %s\n", LOG_FILE);
+        USLOSS_Halt(1);
+    }
+    for (i = 0; i < header.numDecisions && fread(&d[0], sizeof(d[0]), 1, f) == 1; i++)
+        USLOSS_Console("testcase_main(): decision %d: pid %d, reason %d\n", i, d[0].pid, d[0].reason);
+    fclose(f);
+
+    // the next two children will be pids pid2 + 1 and pid2 + 2; run the second one first
+    header.magic = SCHED_LOG_MAGIC;
+    header.numDecisions = 4;
+    d[0].pid = pid2 + 2;   d[0].reason = SCHED_DISPATCH;
+    d[1].pid = tm_pid;     d[1].reason = SCHED_SWITCH;
+    d[2].pid = pid2 + 1;   d[2].reason = SCHED_DISPATCH;
+    d[3].pid = tm_pid;     d[3].reason = SCHED_SWITCH;
+    f = fopen(LOG_FILE, "wb");
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(d, sizeof(d[0]), 4, f);
+    fclose(f);
+
+    USLOSS_Console("testcase_main(): schedLogStartReplay returned %d\n", schedLogStartReplay(LOG_FILE));
+    runTwoChildren("C", "D", &pid1, &pid2);
+    USLOSS_Console("testcase_main(): replay is over: %s\n", (schedLogMode == SCHED_LOG_OFF) ? "yes" : "no");
+    remove(LOG_FILE);
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    USLOSS_Console("XXp1(): %s running, pid %d\n", arg, getpid());
+    quit_phase_1a(0, tm_pid);
+}
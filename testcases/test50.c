@@ -0,0 +1,161 @@
+/*
+ * Check the mailboxes: messages come out in the order they went in, the
+ * Cond versions return -2 instead of waiting, a message sent to a waiting
+ * receiver is handed to it without a slot, a blocked sender is woken when
+ * its message gets a slot, a mailbox with no slots pairs each sender with a
+ * receiver, and releasing a mailbox wakes everyone waiting in it with -1.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <phase2.h>
+
+int Receiver(void *);
+int Sender(void *);
+int SlotSender(void *);
+int ZeroSender(void *);
+int Waiter(void *);
+int Releaser(void *);
+
+int mbox, handMbox, slotMbox, zeroMbox, relMbox;
+
+void joinAll(int n)
+{
+    int i, kidpid, status;
+
+    for (i = 0; i < n; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+}
+
+int testcase_main()
+{
+    char buf[20];
+    int i, rc;
+    struct mboxStats stats;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: each step below prints what it expects next to what it got.\n");
+
+    mbox = MboxCreate(3, 20);
+    USLOSS_Console("testcase_main(): MboxCreate(3, 20) returned %d\n", mbox);
+    USLOSS_Console("testcase_main(): MboxCondRecv on an empty mailbox returned %d (expect -2)\n", MboxCondRecv(mbox, buf, sizeof(buf)));
+    for (i = 0; i < 3; i++) {
+        sprintf(buf, "message %d", i);
+        rc = MboxSend(mbox, buf, strlen(buf) + 1);
+        USLOSS_Console("testcase_main(): MboxSend of '%s' returned %d\n", buf, rc);
+    }
+    USLOSS_Console("testcase_main(): MboxCondSend to a full mailbox returned %d (expect -2)\n", MboxCondSend(mbox, "x", 2));
+    USLOSS_Console("testcase_main(): MboxSend of 21 bytes returned %d (expect -1)\n", MboxSend(mbox, buf, 21));
+    for (i = 0; i < 3; i++) {
+        rc = MboxRecv(mbox, buf, sizeof(buf));
+        USLOSS_Console("testcase_main(): MboxRecv returned %d, '%s'\n", rc, buf);
+    }
+    MboxSend(mbox, "too long", 9);
+    USLOSS_Console("testcase_main(): MboxRecv into a 4 byte buffer returned %d (expect -1)\n", MboxRecv(mbox, buf, 4));
+
+    // Receiver waits first, so Sender's message is handed straight to it
+    handMbox = MboxCreate(3, 20);
+    spork("Receiver", Receiver, NULL, USLOSS_MIN_STACK, 2);
+    spork("Sender", Sender, NULL, USLOSS_MIN_STACK, 4);
+    joinAll(2);
+
+    // SlotSender fills the only slot and waits until we make room
+    slotMbox = MboxCreate(1, 20);
+    spork("SlotSender", SlotSender, NULL, USLOSS_MIN_STACK, 2);
+    for (i = 0; i < 3; i++) {
+        rc = MboxRecv(slotMbox, buf, sizeof(buf));
+        USLOSS_Console("testcase_main(): MboxRecv returned %d, '%s'\n", rc, buf);
+    }
+    joinAll(1);
+
+    // a mailbox with no slots only passes messages to a waiting receiver
+    zeroMbox = MboxCreate(0, 20);
+    USLOSS_Console("testcase_main(): MboxCondSend to a mailbox with no slots returned %d (expect -2)\n", MboxCondSend(zeroMbox, "x", 2));
+    spork("ZeroSender", ZeroSender, NULL, USLOSS_MIN_STACK, 4);
+    rc = MboxRecv(zeroMbox, buf, sizeof(buf));
+    USLOSS_Console("testcase_main(): MboxRecv returned %d, '%s'\n", rc, buf);
+    joinAll(1);
+
+    // Releaser releases the mailbox both Waiters are waiting in
+    relMbox = MboxCreate(2, 20);
+    spork("Waiter", Waiter, NULL, USLOSS_MIN_STACK, 4);
+    spork("Waiter", Waiter, NULL, USLOSS_MIN_STACK, 4);
+    spork("Releaser", Releaser, NULL, USLOSS_MIN_STACK, 5);
+    joinAll(3);
+    USLOSS_Console("testcase_main(): MboxSend to the released mailbox returned %d (expect -1)\n", MboxSend(relMbox, "x", 2));
+
+    getMboxStats(&stats);
+    USLOSS_Console("testcase_main(): sends %ld, handoffs %ld, through slots %ld, free slots %d\n", stats.sends, stats.handoffs, stats.slotsUsed, stats.freeSlots);
+
+    return 0;
+}
+
+int Receiver(void *arg)
+{
+    char buf[20];
+    int rc;
+
+    USLOSS_Console("Receiver(): waiting for a message\n");
+    rc = MboxRecv(handMbox, buf, sizeof(buf));
+    USLOSS_Console("Receiver(): MboxRecv returned %d, '%s'\n", rc, buf);
+    return 1;
+}
+
+int Sender(void *arg)
+{
+    int rc;
+
+    USLOSS_Console("Sender(): sending 'hello'\n");
+    rc = MboxSend(handMbox, "hello", 6);
+    USLOSS_Console("Sender(): MboxSend returned %d\n", rc);
+    return 2;
+}
+
+int SlotSender(void *arg)
+{
+    char buf[20];
+    int i, rc;
+
+    for (i = 0; i < 3; i++) {
+        sprintf(buf, "slot message %d", i);
+        USLOSS_Console("SlotSender(): sending '%s'\n", buf);
+        rc = MboxSend(slotMbox, buf, strlen(buf) + 1);
+        USLOSS_Console("SlotSender(): MboxSend returned %d\n", rc);
+    }
+    return 3;
+}
+
+int ZeroSender(void *arg)
+{
+    int rc;
+
+    USLOSS_Console("ZeroSender(): sending 'zero'\n");
+    rc = MboxSend(zeroMbox, "zero", 5);
+    USLOSS_Console("ZeroSender(): MboxSend returned %d\n", rc);
+    return 4;
+}
+
+int Waiter(void *arg)
+{
+    char buf[20];
+    int rc;
+
+    USLOSS_Console("Waiter(): pid %d waiting for a message\n", getpid());
+    rc = MboxRecv(relMbox, buf, sizeof(buf));
+    USLOSS_Console("Waiter(): pid %d MboxRecv returned %d (expect -1)\n", getpid(), rc);
+    return 5;
+}
+
+int Releaser(void *arg)
+{
+    int rc;
+
+    USLOSS_Console("Releaser(): releasing the mailbox\n");
+    rc = MboxRelease(relMbox);
+    USLOSS_Console("Releaser(): MboxRelease returned %d\n", rc);
+    return 6;
+}
@@ -0,0 +1,63 @@
+/*
+ * Check the read-only queries: getpid(), getpriority(), getstate() and
+ * getparent() for running, runnable, blocked, terminated and joined
+ * processes, for init and for a pid that doesn't exist.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Parent(void *);
+int Kid(void *);
+int Observer(void *);
+
+int parent_pid = -1;
+int kid_pid = -1;
+
+int testcase_main()
+{
+    int kidpid, status;
+
+    USLOSS_Console("testcase_main(): started, pid %d, priority %d\n", getpid(), getpriority());
+    USLOSS_Console("EXPECTATION: Parent creates Kid (priority 2) and Observer (priority 3) and joins.  Kid sees itself Running and Parent Blocked.  When Kid calls quit(), Observer runs before Parent and sees Kid Terminated.  Once Parent has joined Kid, Kid no longer exists.\n");
+
+    parent_pid = spork("Parent", Parent, NULL, USLOSS_MIN_STACK, 4);
+    USLOSS_Console("testcase_main(): getstate(Parent) = %d (expect 0), getparent(Parent) = %d\n", getstate(parent_pid), getparent(parent_pid));
+
+    kidpid = join(&status);
+    USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+
+    return 0;
+}
+
+int Parent(void *arg)
+{
+    int i, kidpid, status;
+
+    kid_pid = spork("Kid", Kid, NULL, USLOSS_MIN_STACK, 2);
+    spork("Observer", Observer, NULL, USLOSS_MIN_STACK, 3);
+    USLOSS_Console("Parent(): getstate(Kid) = %d (expect 0), getparent(Kid) = %d (expect %d)\n", getstate(kid_pid), getparent(kid_pid), getpid());
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("Parent(): join returned %d, status = %d\n", kidpid, status);
+        USLOSS_Console("Parent(): getstate(%d) = %d (expect -1)\n", kidpid, getstate(kidpid));
+    }
+    return 1;
+}
+
+int Kid(void *arg)
+{
+    USLOSS_Console("Kid(): pid %d, priority %d, getstate(self) = %d (expect 1)\n", getpid(), getpriority(), getstate(getpid()));
+    USLOSS_Console("Kid(): getstate(Parent) = %d (expect 3), getparent(self) = %d (expect %d)\n", getstate(parent_pid), getparent(getpid()), parent_pid);
+    quit(2);
+}
+
+int Observer(void *arg)
+{
+    USLOSS_Console("Observer(): getstate(Kid) = %d (expect 2)\n", getstate(kid_pid));
+    USLOSS_Console("Observer(): getparent(init) = %d (expect 0)\n", getparent(1));
+    USLOSS_Console("Observer(): getstate(999) = %d, getparent(999) = %d (expect -1, -1)\n", getstate(999), getparent(999));
+    return 3;
+}
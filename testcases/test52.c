@@ -0,0 +1,59 @@
+/*
+ * Check sporkMany(): the children get their own arguments, run in the
+ * order they were created and can all be joined.  A batch that doesn't fit
+ * in the table creates nothing, and leaves room for one that does.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Worker(void *);
+int Quiet(void *);
+
+int testcase_main()
+{
+    int i, rc, kidpid, status, sum;
+    int pids[MAXPROC];
+    void *args[3] = {"first", "second", "third"};
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: three Workers run oldest first with their own arguments.  A batch of %d fails with -1 and creates nothing, since init and testcase_main leave room for only %d; a batch of %d then succeeds.\n", MAXPROC - 1, MAXPROC - 2, MAXPROC - 2);
+
+    rc = sporkMany("Worker", Worker, args, 3, USLOSS_MIN_STACK, 4, pids);
+    USLOSS_Console("testcase_main(): sporkMany returned %d, pids %d %d %d, %d children\n", rc, pids[0], pids[1], pids[2], getChildCount(getpid()));
+    for (i = 0; i < 3; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    USLOSS_Console("testcase_main(): sporkMany with a small stack returned %d (expect -2)\n", sporkMany("Worker", Worker, NULL, 2, USLOSS_MIN_STACK - 1, 4, pids));
+    USLOSS_Console("testcase_main(): sporkMany of 0 returned %d (expect -1)\n", sporkMany("Worker", Worker, NULL, 0, USLOSS_MIN_STACK, 4, pids));
+
+    rc = sporkMany("Quiet", Quiet, NULL, MAXPROC - 1, USLOSS_MIN_STACK, 4, pids);
+    USLOSS_Console("testcase_main(): sporkMany of %d returned %d (expect -1), %d children\n", MAXPROC - 1, rc, getChildCount(getpid()));
+
+    rc = sporkMany("Quiet", Quiet, NULL, MAXPROC - 2, USLOSS_MIN_STACK, 4, pids);
+    USLOSS_Console("testcase_main(): sporkMany of %d returned %d (expect 0), %d children\n", MAXPROC - 2, rc, getChildCount(getpid()));
+    USLOSS_Console("testcase_main(): spork with a full table returned %d (expect -1)\n", spork("Quiet", Quiet, NULL, USLOSS_MIN_STACK, 4));
+
+    sum = 0;
+    for (i = 0; i < MAXPROC - 2; i++) {
+        kidpid = join(&status);
+        sum += status;
+    }
+    USLOSS_Console("testcase_main(): joined %d children, statuses add up to %d (expect %d)\n", i, sum, MAXPROC - 2);
+
+    return 0;
+}
+
+int Worker(void *arg)
+{
+    USLOSS_Console("Worker(): pid %d, arg '%s'\n", getpid(), (char *)arg);
+    return getpid();
+}
+
+int Quiet(void *arg)
+{
+    return 1;
+}
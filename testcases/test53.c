@@ -0,0 +1,52 @@
+/*
+ * Check that a process blocked in blockMe() stays blocked when one of its
+ * children returns from its start function, which in phase 1a switches
+ * back to the parent.  The dispatcher runs something else instead, and the
+ * parent only runs again once it is unblocked.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Child(void *);
+int Waker(void *);
+
+int tm_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: testcase_main blocks itself.  Child returns, but testcase_main stays blocked, so Waker runs next, sees it Blocked and unblocks it.\n");
+
+    spork("Child", Child, NULL, USLOSS_MIN_STACK, 4);
+    spork("Waker", Waker, NULL, USLOSS_MIN_STACK, 5);
+
+    USLOSS_Console("testcase_main(): calling blockMe(20)\n");
+    status = blockMe(20);
+    USLOSS_Console("testcase_main(): blockMe returned %d, getstate(self) = %d\n", status, getstate(tm_pid));
+
+    for (i = 0; i < 2; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+
+    return 0;
+}
+
+int Child(void *arg)
+{
+    USLOSS_Console("Child(): getstate(testcase_main) = %d (expect 3), returning\n", getstate(tm_pid));
+    return 1;
+}
+
+int Waker(void *arg)
+{
+    USLOSS_Console("Waker(): getstate(testcase_main) = %d (expect 3)\n", getstate(tm_pid));
+    USLOSS_Console("Waker(): unblockProc returned %d\n", unblockProc(tm_pid));
+    return 2;
+}
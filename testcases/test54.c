@@ -0,0 +1,62 @@
+/*
+ * Check that a process waiting in MboxRecv() keeps waiting when something
+ * other than a sender wakes it: Meddler calls unblockProc() on it, and it
+ * must still get the message Sender sends afterwards.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <phase2.h>
+
+int Receiver(void *);
+int Meddler(void *);
+int Sender(void *);
+
+int mbox;
+int receiver_pid = -1;
+
+int testcase_main()
+{
+    int i, kidpid, status;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Receiver waits in MboxRecv.  Meddler unblocks it, but it goes back to waiting, and still gets Sender's message.  MboxCondRecv afterwards finds nothing.\n");
+
+    mbox = MboxCreate(1, 20);
+    receiver_pid = spork("Receiver", Receiver, NULL, USLOSS_MIN_STACK, 2);
+    spork("Meddler", Meddler, NULL, USLOSS_MIN_STACK, 4);
+    spork("Sender", Sender, NULL, USLOSS_MIN_STACK, 5);
+
+    for (i = 0; i < 3; i++) {
+        kidpid = join(&status);
+        USLOSS_Console("testcase_main(): join returned %d, status = %d\n", kidpid, status);
+    }
+    USLOSS_Console("testcase_main(): MboxCondRecv returned %d (expect -2)\n", MboxCondRecv(mbox, NULL, 0));
+
+    return 0;
+}
+
+int Receiver(void *arg)
+{
+    char buf[20];
+    int rc;
+
+    USLOSS_Console("Receiver(): waiting for a message\n");
+    rc = MboxRecv(mbox, buf, sizeof(buf));
+    USLOSS_Console("Receiver(): MboxRecv returned %d, '%s'\n", rc, buf);
+    return 1;
+}
+
+int Meddler(void *arg)
+{
+    USLOSS_Console("Meddler(): unblockProc(Receiver) returned %d\n", unblockProc(receiver_pid));
+    USLOSS_Console("Meddler(): getstate(Receiver) = %d (expect 3)\n", getstate(receiver_pid));
+    return 2;
+}
+
+int Sender(void *arg)
+{
+    USLOSS_Console("Sender(): MboxSend returned %d\n", MboxSend(mbox, "hello", 6));
+    return 3;
+}
@@ -0,0 +1,119 @@
+/*
+ * Check that a run with time-slice preemptions replays exactly.  Three
+ * spinners at the same priority each make a fixed number of kernel calls,
+ * and note which loop iteration they are on whenever they find they have
+ * been switched to.  The run is recorded, the log is rewritten for the
+ * pids of a second set of spinners, and the second set, replayed, must be
+ * switched at the same iterations in the same order.  How many
+ * preemptions there are depends on the speed of the machine, so only that
+ * there were some is printed.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+#include <schedlog.h>
+
+#define LOG_FILE   "test55.log"
+#define TIME_SLICE 20 /* ms */
+#define NUM_SPINNERS 3
+#define ITERATIONS 1500000
+#define MAX_SWITCHES 10000
+#define MAX_DECISIONS 100000
+
+int Spinner(void *);
+
+struct turn {
+    int spinner; /* 0 to NUM_SPINNERS - 1 */
+    int iteration;
+};
+
+struct turn turns[2][MAX_SWITCHES];
+int numTurns[2];
+int run; /* which of turns[] the spinners are filling */
+int lastPid = -1;
+int firstPid;
+struct schedDecision decisions[MAX_DECISIONS];
+
+void runSpinners(void)
+{
+    int i, status;
+
+    lastPid = -1;
+    firstPid = -1;
+    for (i = 0; i < NUM_SPINNERS; i++) {
+        int pid = spork("Spinner", Spinner, NULL, USLOSS_MIN_STACK, 4);
+        if (firstPid == -1)
+            firstPid = pid;
+    }
+    for (i = 0; i < NUM_SPINNERS; i++)
+        join(&status);
+}
+
+int testcase_main()
+{
+    int i, preemptions, oldFirst, same;
+    FILE *f;
+    struct schedLogHeader header;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: the spinners are preempted while recording, and the replayed spinners are switched at exactly the same iterations.\n");
+
+    setTimeSlice(TIME_SLICE);
+
+    run = 0;
+    schedLogStartRecording();
+    runSpinners();
+    schedLogSave(LOG_FILE);
+    oldFirst = firstPid;
+
+    // read the log, count the preemptions and move the spinners' pids to the next set
+    f = fopen(LOG_FILE, "rb");
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1 || header.numDecisions > MAX_DECISIONS ||
+        fread(decisions, sizeof(decisions[0]), header.numDecisions, f) != header.numDecisions) {
+        USLOSS_Console("testcase_main(): could not read %s\n", LOG_FILE);
+        USLOSS_Halt(1);
+    }
+    fclose(f);
+    preemptions = 0;
+    for (i = 0; i < header.numDecisions; i++) {
+        if (decisions[i].reason == SCHED_PREEMPT)
+            preemptions++;
+        if (decisions[i].pid >= oldFirst && decisions[i].pid < oldFirst + NUM_SPINNERS)
+            decisions[i].pid += NUM_SPINNERS;
+    }
+    f = fopen(LOG_FILE, "wb");
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(decisions, sizeof(decisions[0]), header.numDecisions, f);
+    fclose(f);
+    USLOSS_Console("testcase_main(): the recorded run had preemptions: %s\n", (preemptions > 0) ? "yes" : "no");
+
+    run = 1;
+    schedLogStartReplay(LOG_FILE);
+    runSpinners();
+    remove(LOG_FILE);
+    USLOSS_Console("testcase_main(): replay is over: %s\n", (schedLogMode == SCHED_LOG_OFF) ? "yes" : "no");
+
+    same = numTurns[0] == numTurns[1];
+    for (i = 0; same && i < numTurns[0]; i++)
+        same = turns[0][i].spinner == turns[1][i].spinner && turns[0][i].iteration == turns[1][i].iteration;
+    USLOSS_Console("testcase_main(): the replay was switched at the same iterations: %s\n", same ? "yes" : "no");
+
+    return 0;
+}
+
+int Spinner(void *arg)
+{
+    int i, me;
+
+    for (i = 0; i < ITERATIONS; i++) {
+        me = getpid();
+        if (me != lastPid && numTurns[run] < MAX_SWITCHES) {
+            turns[run][numTurns[run]].spinner = me - firstPid;
+            turns[run][numTurns[run]].iteration = i;
+            numTurns[run]++;
+            lastPid = me;
+        }
+    }
+    quit(0);
+}
@@ -0,0 +1,77 @@
+/*
+ * Check the guard page of the mmap stack pool: the page right below a
+ * process' stack can't be read or written, so a stack overflow faults
+ * instead of running into other memory.  The Makefile always links this
+ * test with the pool built with -DSTACK_POOL_MMAP, whichever STACK_BACKEND
+ * the rest is built with.  The mappings are read from /proc/self/maps, so
+ * this needs Linux.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int XXp1(void *);
+
+int tm_pid = -1;
+
+/*
+ * Finds the mapping that contains addr, and the permissions and size of the
+ * mapping that ends where it starts.  Returns 0 if there is no such mapping.
+ */
+static int mappingBelow(unsigned long addr, char *perms, unsigned long *size)
+{
+    char line[256], p[8];
+    unsigned long start, end, prevStart = 0, prevEnd = 0;
+    char prevPerms[8] = "";
+    int found = 0;
+    FILE *f = fopen("/proc/self/maps", "r");
+
+    if (f == NULL)
+        return 0;
+    while (!found && fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "%lx-%lx %7s", &start, &end, p) != 3)
+            continue;
+        if (addr >= start && addr < end) {
+            found = prevEnd == start;
+            strcpy(perms, prevPerms);
+            *size = prevEnd - prevStart;
+        }
+        prevStart = start;
+        prevEnd = end;
+        strcpy(prevPerms, p);
+    }
+    fclose(f);
+    return found;
+}
+
+int testcase_main()
+{
+    int status;
+
+    tm_pid = getpid();
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: the page below a child's stack is a separate mapping, one page long, with no access.\n");
+
+    spork("XXp1", XXp1, NULL, 4 * USLOSS_MIN_STACK, 4);
+    join(&status);
+    USLOSS_Console("testcase_main(): child returned %d\n", status);
+
+    return 0;
+}
+
+int XXp1(void *arg)
+{
+    char local;
+    char perms[8] = "";
+    unsigned long size = 0;
+    int found = mappingBelow((unsigned long)&local, perms, &size);
+
+    USLOSS_Console("XXp1(): there is a mapping right below the stack: %s\n", found ? "yes" : "no");
+    USLOSS_Console("XXp1(): it has no access: %s\n", (found && strncmp(perms, "---", 3) == 0) ? "yes" : "no");
+    USLOSS_Console("XXp1(): it is one page long: %s\n", (found && size == sysconf(_SC_PAGESIZE)) ? "yes" : "no");
+    return 1;
+}
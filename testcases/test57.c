@@ -0,0 +1,36 @@
+/*
+ * Check that TEMP_switchTo() refuses a process that has quit but not been
+ * joined.  Its stack has already gone back to the pool, so switching to
+ * it would resume a context in memory another process may now be using.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+int Child(void *);
+
+int testcase_main()
+{
+    int kidpid;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Child returns and is not joined.  Switching to it halts the simulation with an error.\n");
+
+    kidpid = spork("Child", Child, NULL, USLOSS_MIN_STACK, 3);
+    USLOSS_Console("testcase_main(): switching to Child, pid %d\n", kidpid);
+    TEMP_switchTo(kidpid);
+
+    USLOSS_Console("testcase_main(): back from Child, getstate(%d) = %d (expect 2)\n", kidpid, getstate(kidpid));
+    USLOSS_Console("testcase_main(): switching to Child again\n");
+    TEMP_switchTo(kidpid);
+
+    USLOSS_Console("testcase_main(): TEMP_switchTo returned -- should not see this message!!!!!!!!\n");
+    return 0;
+}
+
+int Child(void *arg)
+{
+    USLOSS_Console("Child(): started, returning\n");
+    return 1;
+}
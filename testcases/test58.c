@@ -0,0 +1,110 @@
+/*
+ * Check that a run preempted inside mailbox operations replays exactly.
+ * Three spinners at the same priority pass messages through one mailbox
+ * with MboxCondSend() and MboxCondRecv(), and fold every message they
+ * receive into a checksum, which depends on the order they ran in.  The
+ * run is recorded, the log is rewritten for the pids of a second set of
+ * spinners, and the second set, replayed, must end with the same
+ * checksums.  The mailbox calls are the only kernel entries the spinners
+ * make, so the preemptions can only be replayed if they are counted.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase2.h>
+#include <schedlog.h>
+
+#define LOG_FILE   "test58.log"
+#define TIME_SLICE 20 /* ms */
+#define NUM_SPINNERS 3
+#define ITERATIONS 300000
+#define MAX_DECISIONS 100000
+
+int Spinner(void *);
+
+unsigned int checksums[2][NUM_SPINNERS];
+int run; /* which of checksums[] the spinners are filling */
+int mbox;
+struct schedDecision decisions[MAX_DECISIONS];
+
+int runSpinners(void)
+{
+    int i, status, firstPid = -1;
+
+    mbox = MboxCreate(5, sizeof(int));
+    for (i = 0; i < NUM_SPINNERS; i++) {
+        int pid = spork("Spinner", Spinner, (void *)(long)i, USLOSS_MIN_STACK, 4);
+        if (firstPid == -1)
+            firstPid = pid;
+    }
+    for (i = 0; i < NUM_SPINNERS; i++)
+        join(&status);
+    MboxRelease(mbox);
+    return firstPid;
+}
+
+int testcase_main()
+{
+    int i, preemptions, oldFirst, same;
+    FILE *f;
+    struct schedLogHeader header;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: the spinners are preempted while recording, and the replayed spinners receive the same messages in the same order.\n");
+
+    setTimeSlice(TIME_SLICE);
+
+    run = 0;
+    schedLogStartRecording();
+    oldFirst = runSpinners();
+    schedLogSave(LOG_FILE);
+
+    // read the log, count the preemptions and move the spinners' pids to the next set
+    f = fopen(LOG_FILE, "rb");
+    if (f == NULL || fread(&header, sizeof(header), 1, f) != 1 || header.numDecisions > MAX_DECISIONS ||
+        fread(decisions, sizeof(decisions[0]), header.numDecisions, f) != header.numDecisions) {
+        USLOSS_Console("testcase_main(): could not read %s\n", LOG_FILE);
+        USLOSS_Halt(1);
+    }
+    fclose(f);
+    preemptions = 0;
+    for (i = 0; i < header.numDecisions; i++) {
+        if (decisions[i].reason == SCHED_PREEMPT)
+            preemptions++;
+        if (decisions[i].pid >= oldFirst && decisions[i].pid < oldFirst + NUM_SPINNERS)
+            decisions[i].pid += NUM_SPINNERS;
+    }
+    f = fopen(LOG_FILE, "wb");
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(decisions, sizeof(decisions[0]), header.numDecisions, f);
+    fclose(f);
+    USLOSS_Console("testcase_main(): the recorded run had preemptions: %s\n", (preemptions > 0) ? "yes" : "no");
+
+    run = 1;
+    schedLogStartReplay(LOG_FILE);
+    runSpinners();
+    remove(LOG_FILE);
+    USLOSS_Console("testcase_main(): replay is over: %s\n", (schedLogMode == SCHED_LOG_OFF) ? "yes" : "no");
+
+    same = 1;
+    for (i = 0; i < NUM_SPINNERS; i++)
+        same = same && checksums[0][i] == checksums[1][i];
+    USLOSS_Console("testcase_main(): the replayed spinners received the same messages: %s\n", same ? "yes" : "no");
+
+    return 0;
+}
+
+int Spinner(void *arg)
+{
+    int i, msg, me = (int)(long)arg;
+    unsigned int sum = 0;
+
+    for (i = 0; i < ITERATIONS; i++) {
+        msg = me * ITERATIONS + i;
+        MboxCondSend(mbox, &msg, sizeof(msg));
+        if (MboxCondRecv(mbox, &msg, sizeof(msg)) >= 0)
+            sum = sum * 31 + msg;
+    }
+    checksums[run][me] = sum;
+    quit(0);
+}
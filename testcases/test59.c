@@ -0,0 +1,65 @@
+/*
+ * Check time slicing with the default quantum: this testcase is built
+ * with -DDEFAULT_TIME_SLICE=80 (SLICED_TESTS in the Makefile) and never
+ * calls setTimeSlice().  Three CPU-bound processes at the same priority
+ * must each get more than one turn, and none may wait too long for its
+ * next turn.  The wait is counted in context switches, from
+ * getKernelStats(), rather than in time, so it doesn't depend on the load
+ * on the machine.  With round-robin, a spinner waits for one turn of each
+ * of the other spinners, a switch into each and one back to it, and each
+ * of them that quits adds a switch, since the CPU goes through
+ * testcase_main, which reaps it, on the way to the next.
+ */
+
+#include <stdio.h>
+#include <usloss.h>
+#include <phase1.h>
+
+#define NUM_SPINNERS 3
+#define SPIN_TIME    300000 /* usec of CPU each spinner uses */
+#define MAX_WAIT     (2 * NUM_SPINNERS - 1) /* context switches between two turns of a spinner */
+
+int Spinner(void *);
+
+int longestWait = 0; /* most context switches any spinner waited between two of its turns */
+
+int testcase_main()
+{
+    int i, status, moreThanOne = 0;
+
+    USLOSS_Console("testcase_main(): started\n");
+    USLOSS_Console("EXPECTATION: Three spinners at priority 4 share the CPU round-robin in the default time slice, without setTimeSlice().  Each gets several turns, and waits at most %d context switches for the next.\n", MAX_WAIT);
+
+    for (i = 0; i < NUM_SPINNERS; i++)
+        spork("Spinner", Spinner, NULL, USLOSS_MIN_STACK, 4);
+
+    for (i = 0; i < NUM_SPINNERS; i++) {
+        join(&status);
+        moreThanOne += status;
+    }
+    USLOSS_Console("testcase_main(): joined %d spinners, all of which had more than one turn: %s\n", NUM_SPINNERS, (moreThanOne == NUM_SPINNERS) ? "yes" : "no");
+    USLOSS_Console("testcase_main(): no spinner waited more than %d context switches for a turn: %s\n", MAX_WAIT, (longestWait <= MAX_WAIT) ? "yes" : "no");
+
+    return 0;
+}
+
+int Spinner(void *arg)
+{
+    int sliceStart = readCurStartTime();
+    long lastSwitches = getKernelStats().contextSwitches;
+    int turns = 1;
+
+    while (readtime() < SPIN_TIME) {
+        /* a new time slice started since we last looked */
+        if (readCurStartTime() != sliceStart) {
+            long switches = getKernelStats().contextSwitches;
+            sliceStart = readCurStartTime();
+            if (switches - lastSwitches > longestWait)
+                longestWait = switches - lastSwitches;
+            lastSwitches = switches;
+            turns++;
+        }
+    }
+
+    quit(turns > 1);
+}
@@ -0,0 +1,190 @@
+/*
+ * Authors: Colton Patch, Ping Tontrasathien
+ * tracedump.c - Host-side decoder for the kernel's scheduler trace (see trace.h). Prints a 
+ * 	timeline of the events in a trace file, then a summary for each pid: how often it was 
+ * 	switched to, the CPU time it got, and how long it waited to run after becoming runnable.
+ *
+ * 	usage: tracedump [-s] <trace file>
+ * 		-s	print only the per-pid summary
+ */
+
+#include <trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//
+// per-pid totals, indexed by pid
+//
+struct pidSummary {
+	int seen;
+	int switches; // times switched to
+	long cpuTime; // microseconds between being switched to and away from
+	int runningSince; // time it was last switched to, -1 if not running
+	int readySince; // time it last became runnable, -1 if not waiting to run
+	int waits; // number of waits measured
+	long totalWait;
+	int maxWait;
+};
+
+char *typeNames[TRACE_NUM_TYPES] = {"?", "SPORK", "SWITCH", "BLOCK", "WAKE", "QUIT", "JOIN", "ZAP"};
+
+struct pidSummary *pids = NULL;
+int numPids = 0;
+
+/*
+* struct pidSummary *summaryOf(int pid) - returns the totals for a pid, growing the table if needed.
+*	Returns NULL for pid 0, which stands for no process.
+*	pid - the pid
+*/
+struct pidSummary *summaryOf(int pid) {
+	if (pid <= 0) {
+		return NULL;
+	}
+	if (pid >= numPids) {
+		int newSize = (pid + 1) * 2;
+		pids = realloc(pids, newSize * sizeof(struct pidSummary));
+		if (pids == NULL) {
+			fprintf(stderr, "tracedump: out of memory\n");
+			exit(1);
+		}
+		for (int i = numPids; i < newSize; i++) {
+			memset(&pids[i], 0, sizeof(struct pidSummary));
+			pids[i].runningSince = -1;
+			pids[i].readySince = -1;
+		}
+		numPids = newSize;
+	}
+	pids[pid].seen = 1;
+	return &pids[pid];
+}
+
+/*
+* void printEvent(struct traceEvent *e) - prints one event of the timeline.
+*	e - the event
+*/
+void printEvent(struct traceEvent *e) {
+	char *name = (e->type > 0 && e->type < TRACE_NUM_TYPES) ? typeNames[e->type] : "?";
+	printf("%10d  %-6s  pid %-5d", e->time, name, e->pid);
+	switch (e->type) {
+	case TRACE_SPORK:
+		printf("  by %d, priority %d", e->otherPid, e->status);
+		break;
+	case TRACE_SWITCH:
+		if (e->otherPid != 0) {
+			printf("  from %d (%s)", e->otherPid, (e->status == 0) ? "runnable" : (e->status == 2) ? "terminated" : "blocked");
+		}
+		break;
+	case TRACE_BLOCK:
+		printf("  reason %d", e->status);
+		break;
+	case TRACE_WAKE:
+		printf("  by %d", e->otherPid);
+		break;
+	case TRACE_QUIT:
+		printf("  status %d", e->status);
+		break;
+	case TRACE_JOIN:
+		printf("  child %d, status %d", e->otherPid, e->status);
+		break;
+	case TRACE_ZAP:
+		printf("  target %d", e->otherPid);
+		break;
+	}
+	printf("\n");
+}
+
+/*
+* void account(struct traceEvent *e) - adds an event to the per-pid totals.
+*	e - the event
+*/
+void account(struct traceEvent *e) {
+	struct pidSummary *p = summaryOf(e->pid);
+	struct pidSummary *other = summaryOf(e->otherPid);
+
+	switch (e->type) {
+	case TRACE_SPORK:
+	case TRACE_WAKE:
+		p->readySince = e->time;
+		break;
+	case TRACE_SWITCH:
+		// the old process stops running, and waits again if it is still runnable
+		if (other != NULL && other->runningSince != -1) {
+			other->cpuTime += e->time - other->runningSince;
+			other->runningSince = -1;
+			other->readySince = (e->status == 0) ? e->time : -1;
+		}
+		p->switches++;
+		p->runningSince = e->time;
+		if (p->readySince != -1) {
+			int wait = e->time - p->readySince;
+			p->waits++;
+			p->totalWait += wait;
+			if (wait > p->maxWait) {
+				p->maxWait = wait;
+			}
+			p->readySince = -1;
+		}
+		break;
+	}
+}
+
+int main(int argc, char **argv) {
+	int summaryOnly = 0;
+	char *path = NULL;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "-s") == 0) {
+			summaryOnly = 1;
+		}
+		else {
+			path = argv[i];
+		}
+	}
+	if (path == NULL) {
+		fprintf(stderr, "usage: %s [-s] <trace file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *f = fopen(path, "rb");
+	if (f == NULL) {
+		perror(path);
+		return 1;
+	}
+	struct traceHeader header;
+	if (fread(&header, sizeof(header), 1, f) != 1 || header.magic != TRACE_MAGIC || header.version != 1) {
+		fprintf(stderr, "tracedump: %s is not a version 1 trace file\n", path);
+		return 1;
+	}
+
+	// timeline
+	if (!summaryOnly) {
+		printf("%d events", header.numEvents);
+		if (header.dropped > 0) {
+			printf(", %d older events were overwritten", header.dropped);
+		}
+		printf("\n%10s  %-6s  %s\n", "TIME(us)", "EVENT", "DETAILS");
+	}
+	struct traceEvent e;
+	int count = 0;
+	while (count < header.numEvents && fread(&e, sizeof(e), 1, f) == 1) {
+		if (!summaryOnly) {
+			printEvent(&e);
+		}
+		account(&e);
+		count++;
+	}
+	fclose(f);
+	if (count < header.numEvents) {
+		fprintf(stderr, "tracedump: %s is truncated, read %d of %d events\n", path, count, header.numEvents);
+	}
+
+	// per-pid summary; a pid still running at the end of the trace isn't charged for its last slice
+	printf("\n%5s  %8s  %12s  %12s  %12s\n", "PID", "SWITCHES", "CPU(us)", "AVG_WAIT(us)", "MAX_WAIT(us)");
+	for (int pid = 1; pid < numPids; pid++) {
+		struct pidSummary *p = &pids[pid];
+		if (p->seen) {
+			printf("%5d  %8d  %12ld  %12ld  %12d\n", pid, p->switches, p->cpuTime, p->waits ? p->totalWait / p->waits : 0, p->maxWait);
+		}
+	}
+	return 0;
+}
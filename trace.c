@@ -0,0 +1,75 @@
+/*
+ * Authors: Colton Patch, Ping Tontrasathien
+ * trace.c - Keeps a ring buffer of scheduler events and writes it to a file. traceRecord() must be
+ * 	called with interrupts disabled, which every kernel path that records an event already has.
+ */
+
+#include <trace.h>
+#include <usloss.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//
+// global variables
+//
+struct traceEvent traceRing[TRACE_SIZE];
+unsigned long traceCount = 0; // number of events ever recorded; the next goes in traceCount % TRACE_SIZE
+
+//
+// functions
+//
+
+/*
+* void traceRecord(int type, int pid, int otherPid, int status) - adds an event to the ring, 
+*	timestamped with the clock, overwriting the oldest event if it is full.
+*	type - one of the TRACE_ event types
+*	pid - the process the event is about
+*	otherPid - the other process involved, 0 if none
+*	status - event-specific value
+*/
+void traceRecord(int type, int pid, int otherPid, int status) {
+	struct traceEvent *e = &traceRing[traceCount & (TRACE_SIZE - 1)];
+	if (USLOSS_DeviceInput(USLOSS_CLOCK_DEV, 0, &e->time) != USLOSS_DEV_OK) {
+		e->time = 0;
+	}
+	e->type = type;
+	e->pid = pid;
+	e->otherPid = otherPid;
+	e->status = status;
+	traceCount++;
+}
+
+/*
+* int traceDump(char *path) - writes a header and the events in the ring, oldest first, to a file.
+*	Returns the number of events written, or -1 if the file couldn't be written.
+*	path - name of the file
+*/
+int traceDump(char *path) {
+	FILE *f = fopen(path, "wb");
+	if (f == NULL) {
+		return -1;
+	}
+
+	unsigned long first = (traceCount > TRACE_SIZE) ? traceCount - TRACE_SIZE : 0;
+	struct traceHeader header = {TRACE_MAGIC, 1, traceCount - first, first};
+	int ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	for (unsigned long i = first; ok && i < traceCount; i++) {
+		ok = fwrite(&traceRing[i & (TRACE_SIZE - 1)], sizeof(struct traceEvent), 1, f) == 1;
+	}
+
+	if (fclose(f) != 0 || !ok) {
+		return -1;
+	}
+	return header.numEvents;
+}
+
+/*
+* void traceDumpAtExit(void) - writes the ring to the file named by the PHASE1_TRACE environment
+*	variable, if it is set. Registered with atexit() so it runs when USLOSS_Halt() exits.
+*/
+void traceDumpAtExit(void) {
+	char *path = getenv("PHASE1_TRACE");
+	if (path != NULL && *path != '\0' && traceDump(path) == -1) {
+		fprintf(stderr, "ERROR: Could not write the trace to %s\n", path);
+	}
+}
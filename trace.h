@@ -0,0 +1,65 @@
+/*
+ * Definitions for the kernel's scheduler event trace. The kernel records a
+ * compact binary event on each scheduling path into a fixed-size ring buffer,
+ * overwriting the oldest events once it is full. The ring can be written to a
+ * file with traceDump(), and is written automatically when the simulation
+ * exits if the PHASE1_TRACE environment variable names a file. Decode the
+ * file with tools/tracedump.
+ *
+ * This header is also included by tools/tracedump.c, which is built for the
+ * host, so it must not depend on USLOSS.
+ */
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+/*
+ * Number of events kept in the ring; a power of two.
+ */
+
+#define TRACE_SIZE 4096
+
+/*
+ * Event types
+ */
+
+#define TRACE_SPORK  1 // pid was created by otherPid; status is its priority
+#define TRACE_SWITCH 2 // pid was switched to from otherPid; status is otherPid's state after the switch
+#define TRACE_BLOCK  3 // pid blocked; status is the block reason
+#define TRACE_WAKE   4 // pid was made runnable by otherPid
+#define TRACE_QUIT   5 // pid quit with status; otherPid is its parent
+#define TRACE_JOIN   6 // pid joined its child otherPid, which quit with status
+#define TRACE_ZAP    7 // pid zapped otherPid
+
+#define TRACE_NUM_TYPES 8
+
+/*
+ * One event
+ */
+
+struct traceEvent {
+	int time; // clock time in microseconds
+	int type;
+	int pid;
+	int otherPid; // 0 if none
+	int status;
+};
+
+/*
+ * Header at the start of a trace file, followed by numEvents events, oldest first
+ */
+
+#define TRACE_MAGIC 0x43525450 // "PTRC"
+
+struct traceHeader {
+	int magic;
+	int version; // 1
+	int numEvents;
+	int dropped; // events overwritten before the dump
+};
+
+extern void traceRecord(int type, int pid, int otherPid, int status);
+extern int  traceDump(char *path);
+extern void traceDumpAtExit(void);
+
+#endif /* _TRACE_H */